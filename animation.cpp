@@ -0,0 +1,245 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "animation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/*
+	The hot data of an animation. Callbacks are kept apart, so updating only walks over this.
+*/
+struct Tween {
+	float from, to, duration, elapsed, value;
+	Animation::Ease ease;
+	bool active, loop;
+	u16 generation;
+};
+
+static std::vector<Tween> tweens;
+static std::vector<std::function<void()>> callbacks;
+static std::vector<u16> freeSlots;
+static size_t activeCount = 0;
+static u64 startTick = 0, lastTick = 0;
+static float timeStep = 0, steppedTime = 0;
+
+static float applyEase(Animation::Ease ease, float t) {
+	switch(ease) {
+		case Animation::Ease::InQuad:
+			return t * t;
+
+		case Animation::Ease::OutQuad:
+			return t * (2.0f - t);
+
+		case Animation::Ease::InOutQuad:
+			return t < 0.5f ? 2.0f * t * t : -1.0f + (4.0f - 2.0f * t) * t;
+
+		case Animation::Ease::InOutSine:
+			return 0.5f - 0.5f * cosf(t * M_PI);
+
+		case Animation::Ease::Linear:
+		default:
+			return t;
+	}
+}
+
+/*
+	Return the animation for an ID, or nullptr if it isn't running anymore.
+
+	Animation::Id id: The ID of the animation.
+*/
+static Tween *find(Animation::Id id) {
+	const size_t slot = (id & 0xFFFF) - 1;
+
+	if (slot >= tweens.size()) return nullptr;
+	Tween &tween = tweens[slot];
+
+	return (tween.active && tween.generation == (id >> 16)) ? &tween : nullptr;
+}
+
+/*
+	Free the slot of an animation.
+
+	size_t slot: The slot.
+*/
+static void release(size_t slot) {
+	tweens[slot].active = false;
+	callbacks[slot] = nullptr;
+	freeSlots.push_back(slot);
+	activeCount--;
+}
+
+/*
+	Start an animation.
+
+	float from: The start value.
+	float to: The end value.
+	float duration: The duration in seconds.
+	Animation::Ease ease: The easing curve.
+	const std::function<void()> &done: Called once the animation finished.
+	bool loop: Whether to restart from the beginning after finishing.
+
+	Returns 0, if all slots are in use.
+*/
+Animation::Id Animation::start(float from, float to, float duration, Animation::Ease ease, const std::function<void()> &done, bool loop) {
+	size_t slot;
+
+	if (!freeSlots.empty()) {
+		slot = freeSlots.back();
+		freeSlots.pop_back();
+
+	} else {
+		if (tweens.size() >= MAX_RUNNING) return 0;
+
+		slot = tweens.size();
+		tweens.push_back({ 0, 0, 0, 0, 0, Animation::Ease::Linear, false, false, 0 });
+		callbacks.push_back(nullptr);
+	}
+
+	Tween &tween = tweens[slot];
+	tween = { from, to, std::max(duration, 0.0001f), 0, from, ease, true, loop, (u16)(tween.generation + 1) };
+	callbacks[slot] = done;
+	activeCount++;
+
+	if (!lastTick) lastTick = svcGetSystemTick(); // Don't count the time before the first animation.
+	return ((Animation::Id)tween.generation << 16) | (slot + 1);
+}
+
+/*
+	Stop an animation.
+
+	Animation::Id id: The ID of the animation.
+*/
+void Animation::stop(Animation::Id id) {
+	if (find(id)) release((id & 0xFFFF) - 1);
+}
+
+/*
+	Return if the animation is still running.
+
+	Animation::Id id: The ID of the animation.
+*/
+bool Animation::running(Animation::Id id) { return find(id) != nullptr; };
+
+/*
+	Return the current value of a running animation.
+
+	Animation::Id id: The ID of the animation.
+*/
+float Animation::value(Animation::Id id) {
+	const Tween *tween = find(id);
+
+	return tween ? tween->value : 0.0f;
+}
+
+/*
+	Return if any animation is running.
+*/
+bool Animation::anyRunning(void) { return activeCount > 0; };
+
+/*
+	Advance all animations by the real time passed since the last update.
+*/
+void Animation::update(void) {
+	if (timeStep > 0) {
+		steppedTime += timeStep;
+		Animation::update(timeStep);
+		return;
+	}
+
+	const u64 now = svcGetSystemTick();
+	const float delta = lastTick ? (float)(now - lastTick) / SYSCLOCK_ARM11 : 0.0f;
+	lastTick = now;
+
+	/* Longer stalls, like the HOME Menu, would otherwise skip whole animations. */
+	Animation::update(std::min(delta, 0.25f));
+}
+
+/*
+	Advance all animations by a fixed time.
+
+	float delta: The time in seconds.
+*/
+void Animation::update(float delta) {
+	if (activeCount == 0) return;
+
+	std::vector<std::pair<size_t, u16>> finished; // The slot and its generation.
+
+	for (size_t slot = 0; slot < tweens.size(); slot++) {
+		Tween &tween = tweens[slot];
+		if (!tween.active) continue;
+
+		tween.elapsed += delta;
+
+		if (tween.elapsed >= tween.duration) {
+			if (tween.loop) {
+				tween.elapsed = fmodf(tween.elapsed, tween.duration);
+
+			} else {
+				tween.value = tween.to;
+				finished.push_back({ slot, tween.generation });
+				continue;
+			}
+		}
+
+		tween.value = tween.from + (tween.to - tween.from) * applyEase(tween.ease, tween.elapsed / tween.duration);
+	}
+
+	/*
+		Callbacks may start new animations, so only call them after walking the array.
+		A callback may also stop another finished animation, maybe with its slot reused already, so skip those.
+	*/
+	for (const std::pair<size_t, u16> &entry : finished) {
+		const size_t slot = entry.first;
+		if (!tweens[slot].active || tweens[slot].generation != entry.second) continue;
+
+		std::function<void()> done = std::move(callbacks[slot]);
+		release(slot);
+		if (done) done();
+	}
+}
+
+/*
+	Return the seconds passed since the first use.
+*/
+float Animation::time(void) {
+	if (timeStep > 0) return steppedTime;
+	if (!startTick) startTick = svcGetSystemTick();
+
+	return (float)(svcGetSystemTick() - startTick) / SYSCLOCK_ARM11;
+}
+
+/*
+	Let 'update' advance by a fixed time instead of the real time.
+
+	float step: The time in seconds per 'update', 0 for the real time again.
+*/
+void Animation::setTimeStep(float step) {
+	timeStep = step;
+	steppedTime = 0;
+	lastTick = 0; // Don't count the fixed steps as one long real time update afterwards.
+}
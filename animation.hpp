@@ -0,0 +1,116 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_ANIMATION_HPP
+#define _UNIVERSAL_CORE_ANIMATION_HPP
+
+#include <3ds.h>
+#include <functional>
+
+/*
+	Time based animations.
+
+	All animations live in one flat array and get advanced by the real time passed, so dropped frames
+	don't change how long an animation takes. 'Gui::fadeEffects' calls 'update' every frame,
+	if you don't use it, call 'update' yourself once per frame.
+*/
+namespace Animation {
+	enum class Ease : u8 { Linear, InQuad, OutQuad, InOutQuad, InOutSine };
+
+	typedef u32 Id; // 0 is never a valid ID.
+
+	/* The most animations running at once, the slot is the low 16 bits of the ID and the generation the high ones. */
+	constexpr size_t MAX_RUNNING = 0xFFFF;
+
+	/*
+		Start an animation.
+
+		from: The start value.
+		to: The end value.
+		duration: The duration in seconds.
+		ease: The easing curve. (Optional!)
+		done: Called once the animation finished. Not called for looping ones. (Optional!)
+		loop: Whether to restart from the beginning after finishing. (Optional!)
+
+		Returns 0 without starting it, if 'MAX_RUNNING' animations run already.
+	*/
+	Id start(float from, float to, float duration, Ease ease = Ease::Linear, const std::function<void()> &done = nullptr, bool loop = false);
+
+	/*
+		Stop an animation, without calling its done callback.
+
+		id: The ID of the animation.
+	*/
+	void stop(Id id);
+
+	/*
+		Return if the animation is still running.
+
+		id: The ID of the animation.
+	*/
+	bool running(Id id);
+
+	/*
+		Return the current value of a running animation, or 0 if it isn't running.
+
+		id: The ID of the animation.
+	*/
+	float value(Id id);
+
+	/*
+		Return if any animation is running.
+	*/
+	bool anyRunning(void);
+
+	/*
+		Advance all animations by the real time passed since the last update.
+		Calling it more than once per frame is fine.
+	*/
+	void update(void);
+
+	/*
+		Advance all animations by a fixed time.
+
+		delta: The time in seconds.
+	*/
+	void update(float delta);
+
+	/*
+		Return the seconds passed since the first use, for continuous effects like pulsing.
+		With a fixed time step, the summed up steps instead.
+	*/
+	float time(void);
+
+	/*
+		Let 'update' advance by a fixed time instead of the real time, for reproducible runs like input replays.
+		'update' then must only get called once per frame.
+
+		step: The time in seconds per 'update', 0 for the real time again.
+	*/
+	void setTimeStep(float step);
+};
+
+#endif
@@ -0,0 +1,608 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "asyncLoader.hpp"
+#include "gui.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <sys/stat.h>
+#include <unordered_map>
+
+static Thread loaderThread = nullptr;
+static LightLock queueLock;
+static LightEvent queueEvent;
+static std::deque<std::shared_ptr<AsyncAsset>> queue;
+static bool stopLoader = false;
+
+/*
+	citro2d objects only get created and free'd on the main thread. 'queueLock' also guards what other threads leave to it,
+	the read assets to finish and the SpriteSheets / Fonts of assets, which got free'd on another thread.
+	'Gui::finishAssets' takes care of both.
+*/
+static std::vector<std::shared_ptr<AsyncAsset>> readAssets;
+static std::vector<C2D_SpriteSheet> droppedSheets;
+static std::vector<C2D_Font> droppedFonts;
+
+/*
+	'assetLock' guards everything besides the queue, so assets can also be loaded from other threads,
+	like the factory of 'Gui::setScreenDeferred' or a threaded 'Logic'. The locks get set up before 'main'.
+*/
+static RecursiveLock assetLock;
+
+static bool initLocks(void) {
+	RecursiveLock_Init(&assetLock);
+	LightLock_Init(&queueLock);
+	LightEvent_Init(&queueEvent, RESET_ONESHOT);
+	return true;
+}
+
+static bool onMainThread(void) { return !threadGetCurrent(); };
+
+static const bool locksReady = initLocks();
+
+/*
+	Holds 'assetLock' for a scope.
+*/
+class AssetLock {
+public:
+	AssetLock() { RecursiveLock_Lock(&assetLock); };
+	~AssetLock() { RecursiveLock_Unlock(&assetLock); };
+};
+
+static std::unordered_map<std::string, std::shared_ptr<AsyncAsset>> prefetched;
+static C2D_SpriteSheet placeholderSheet = nullptr;
+static size_t placeholderIndex = 0;
+
+/*
+	Asset registry.
+
+	Resident assets by path. Unreferenced ones stay resident while they fit into 'assetBudget'.
+*/
+struct RegistryEntry {
+	std::shared_ptr<AsyncAsset> asset;
+	int references;
+	u32 lastUse;
+};
+
+static std::unordered_map<std::string, RegistryEntry> registry;
+static size_t assetBudget = 0;
+static u32 registryClock = 0;
+
+AsyncAsset::AsyncAsset(Type type, const std::string &path) : type(type), path(path), state(State::Queued) {
+	LightEvent_Init(&this->read, RESET_STICKY);
+	LightEvent_Init(&this->done, RESET_STICKY);
+}
+
+/*
+	Free a Font. Runs on the main thread.
+
+	C2D_Font fnt: The Font.
+*/
+static void freeFont(C2D_Font fnt) {
+	Gui::invalidateTextCache(fnt);
+	C2D_FontFree(fnt);
+}
+
+AsyncAsset::~AsyncAsset() {
+	if (!this->sheet && !this->font) return;
+
+	if (onMainThread()) {
+		if (this->sheet) C2D_SpriteSheetFree(this->sheet);
+		if (this->font) freeFont(this->font);
+		return;
+	}
+
+	/* Leave them to the main thread. */
+	LightLock_Lock(&queueLock);
+	if (this->sheet) droppedSheets.push_back(this->sheet);
+	if (this->font) droppedFonts.push_back(this->font);
+	LightLock_Unlock(&queueLock);
+}
+
+/*
+	Read the file. Runs on the loader thread.
+*/
+void AsyncAsset::Read() {
+	FILE *file = fopen(this->path.c_str(), "rb");
+
+	if (file) {
+		fseek(file, 0, SEEK_END);
+		const long size = ftell(file);
+		fseek(file, 0, SEEK_SET);
+
+		if (size > 0) {
+			this->data.resize(size);
+			if (fread(this->data.data(), 1, size, file) != (size_t)size) this->data.clear();
+		}
+
+		fclose(file);
+	}
+
+	this->bytes = this->data.size();
+	this->state = this->data.empty() ? State::Failed : State::Read;
+	LightEvent_Signal(&this->read);
+	if (this->Failed()) LightEvent_Signal(&this->done);
+}
+
+/*
+	Let the asset fail without reading it, when the loader thread can't read it anymore.
+*/
+void AsyncAsset::Cancel() {
+	this->state = State::Failed;
+	LightEvent_Signal(&this->read);
+	LightEvent_Signal(&this->done);
+}
+
+/*
+	Create the SpriteSheet / Font from the read file. Runs on the main thread.
+*/
+void AsyncAsset::Finish() {
+	if (this->type == Type::Sheet) this->sheet = C2D_SpriteSheetLoadFromMem(this->data.data(), this->data.size());
+	else this->font = C2D_FontLoadFromMem(this->data.data(), this->data.size());
+
+	std::vector<u8>().swap(this->data); // Both got copied, so free the file data.
+	this->CountTextureBytes();
+	this->state = (this->sheet || this->font) ? State::Ready : State::Failed;
+	LightEvent_Signal(&this->done);
+}
+
+/*
+	Load the SpriteSheet / Font right away from its path, without a copy of the file in memory.
+	Runs on the main thread.
+*/
+void AsyncAsset::Load() {
+	if (this->type == Type::Sheet) {
+		this->sheet = C2D_SpriteSheetLoad(this->path.c_str());
+
+	} else {
+		struct stat info;
+		if (stat(this->path.c_str(), &info) == 0) this->bytes = info.st_size;
+
+		this->font = C2D_FontLoad(this->path.c_str());
+	}
+
+	this->CountTextureBytes();
+	this->state = (this->sheet || this->font) ? State::Ready : State::Failed;
+	LightEvent_Signal(&this->read);
+	LightEvent_Signal(&this->done);
+}
+
+/*
+	Set the size of a SpriteSheet to the size of its textures.
+*/
+void AsyncAsset::CountTextureBytes() {
+	if (!this->sheet) return;
+
+	std::vector<const C3D_Tex *> textures;
+	this->bytes = 0;
+
+	for (size_t i = 0; i < C2D_SpriteSheetCount(this->sheet); i++) {
+		const C3D_Tex *tex = C2D_SpriteSheetGetImage(this->sheet, i).tex;
+
+		if (std::find(textures.begin(), textures.end(), tex) == textures.end()) {
+			textures.push_back(tex);
+			this->bytes += tex->size;
+		}
+	}
+}
+
+/*
+	Return if the asset got loaded. On the main thread, a read asset gets finished right away.
+*/
+bool AsyncAsset::Ready() {
+	if (this->state == State::Read && onMainThread()) this->Finish();
+	return this->state == State::Ready;
+}
+
+/*
+	Block until the asset is loaded or failed. Other threads wait for the main thread to finish it.
+*/
+void AsyncAsset::Wait() {
+	if (onMainThread()) {
+		LightEvent_Wait(&this->read);
+		this->Ready();
+
+	} else {
+		LightEvent_Wait(&this->done);
+	}
+}
+
+/*
+	The loader thread. Reads the queued files one after another.
+*/
+static void loaderMain(void *) {
+	bool running = true;
+
+	while (running) {
+		LightEvent_Wait(&queueEvent);
+
+		while (true) {
+			LightLock_Lock(&queueLock);
+			if (stopLoader || queue.empty()) {
+				running = !stopLoader;
+				LightLock_Unlock(&queueLock);
+				break;
+			}
+
+			std::shared_ptr<AsyncAsset> asset = queue.front();
+			queue.pop_front();
+			LightLock_Unlock(&queueLock);
+
+			asset->Read();
+
+			if (asset->GetState() == AsyncAsset::State::Read) { // Left to the main thread.
+				LightLock_Lock(&queueLock);
+				readAssets.push_back(std::move(asset));
+				LightLock_Unlock(&queueLock);
+			}
+		}
+	}
+}
+
+/*
+	Queue an asset and start the loader thread, if it isn't running yet.
+
+	AsyncAsset::Type type: The type of the asset.
+	const char *Path: The path to the file.
+*/
+static std::shared_ptr<AsyncAsset> queueAsset(AsyncAsset::Type type, const char *Path) {
+	AssetLock lock;
+	auto found = prefetched.find(Path);
+	if (found != prefetched.end()) {
+		std::shared_ptr<AsyncAsset> asset = found->second;
+		prefetched.erase(found);
+		return asset;
+	}
+
+	if (!loaderThread) {
+		s32 priority = 0x30;
+		svcGetThreadPriority(&priority, CUR_THREAD_HANDLE);
+		stopLoader = false;
+
+		/* Slightly lower priority than the main thread, so it runs while the main thread waits for VBlank. */
+		loaderThread = threadCreate(loaderMain, nullptr, 0x8000, priority + 1, -2, false);
+	}
+
+	std::shared_ptr<AsyncAsset> asset = std::make_shared<AsyncAsset>(type, Path);
+	if (!loaderThread) { // Nothing would ever read it.
+		asset->Cancel();
+		return asset;
+	}
+
+	LightLock_Lock(&queueLock);
+	queue.push_back(asset);
+	LightLock_Unlock(&queueLock);
+	LightEvent_Signal(&queueEvent);
+
+	return asset;
+}
+
+/*
+	Start loading a SpriteSheet in the background.
+
+	const char *Path: The path to the file.
+*/
+std::shared_ptr<AsyncAsset> Gui::loadSheetAsync(const char *Path) { return queueAsset(AsyncAsset::Type::Sheet, Path); };
+
+/*
+	Start loading a Font in the background.
+
+	const char *Path: The path to the file.
+*/
+std::shared_ptr<AsyncAsset> Gui::loadFontAsync(const char *Path) { return queueAsset(AsyncAsset::Type::Font, Path); };
+
+/*
+	Prefetch a SpriteSheet.
+
+	const char *Path: The path to the file.
+*/
+void Gui::prefetchSheet(const char *Path) {
+	AssetLock lock;
+	if (prefetched.find(Path) == prefetched.end()) prefetched[Path] = Gui::loadSheetAsync(Path);
+}
+
+/*
+	Prefetch a Font.
+
+	const char *Path: The path to the file.
+*/
+void Gui::prefetchFont(const char *Path) {
+	AssetLock lock;
+	if (prefetched.find(Path) == prefetched.end()) prefetched[Path] = Gui::loadFontAsync(Path);
+}
+
+/*
+	Drop all prefetched assets, which didn't get taken over.
+*/
+void Gui::clearPrefetched(void) {
+	AssetLock lock;
+	prefetched.clear();
+}
+
+/*
+	Draw a sprite from a SpriteSheet, which gets loaded in the background.
+
+	const std::shared_ptr<AsyncAsset> &sheet: The handle of the SpriteSheet.
+	size_t imgindex: The image index.
+	int x: The X-Position where to draw the sprite.
+	int y: The Y-Position where to draw the sprite.
+	float ScaleX: The X-Scale of the sprite.
+	float ScaleY: The Y-Scale of the sprite.
+*/
+void Gui::DrawSprite(const std::shared_ptr<AsyncAsset> &sheet, size_t imgindex, int x, int y, float ScaleX, float ScaleY) {
+	if (sheet && sheet->Ready()) Gui::DrawSprite(sheet->Sheet(), imgindex, x, y, ScaleX, ScaleY);
+	else if (placeholderSheet) Gui::DrawSprite(placeholderSheet, placeholderIndex, x, y, ScaleX, ScaleY);
+}
+
+/*
+	Set the placeholder sprite.
+
+	C2D_SpriteSheet sheet: The SpriteSheet of the placeholder. nullptr draws nothing.
+	size_t imgindex: The index of the placeholder sprite.
+*/
+void Gui::setAsyncPlaceholder(C2D_SpriteSheet sheet, size_t imgindex) {
+	placeholderSheet = sheet;
+	placeholderIndex = imgindex;
+}
+
+/*
+	Stop the loader thread. The assets in the registry stay, apps may still hold them.
+*/
+void Gui::stopAsyncLoader(void) {
+	AssetLock lock;
+	prefetched.clear();
+	if (!loaderThread) return;
+
+	LightLock_Lock(&queueLock);
+	stopLoader = true;
+	for (const std::shared_ptr<AsyncAsset> &asset : queue) asset->Cancel(); // Waiting for them would block forever.
+	queue.clear();
+	LightLock_Unlock(&queueLock);
+	LightEvent_Signal(&queueEvent);
+
+	threadJoin(loaderThread, U64_MAX);
+	threadFree(loaderThread);
+	loaderThread = nullptr;
+}
+
+/*
+	Free the least recently used unreferenced assets, until they fit into the budget.
+	Only on the main thread, other threads leave it to the next 'Gui::finishAssets'.
+*/
+static void trimRegistry(void) {
+	if (threadGetCurrent()) return; // Not the main thread.
+
+	while (true) {
+		size_t unused = 0;
+		auto oldest = registry.end();
+
+		for (auto it = registry.begin(); it != registry.end(); ++it) {
+			if (it->second.references > 0) continue;
+
+			unused += it->second.asset->Bytes();
+			if (oldest == registry.end() || it->second.lastUse < oldest->second.lastUse) oldest = it;
+		}
+
+		/* A budget of 0 frees every unreferenced asset, failed loads never need to stay. */
+		if (oldest == registry.end()) return;
+		if (assetBudget > 0 && unused <= assetBudget && !oldest->second.asset->Failed()) return;
+
+		/* Take the asset out first, freeing a Font calls back into the Gui. */
+		std::shared_ptr<AsyncAsset> asset = std::move(oldest->second.asset);
+		registry.erase(oldest);
+	}
+}
+
+/*
+	Return the registry key of an asset. SpriteSheets and Fonts don't share entries.
+
+	AsyncAsset::Type type: The type of the asset.
+	const char *Path: The path to the file.
+*/
+static std::string registryKey(AsyncAsset::Type type, const char *Path) {
+	return (type == AsyncAsset::Type::Sheet ? "s:" : "f:") + std::string(Path);
+}
+
+/*
+	Drop a reference of a registry entry.
+
+	const std::string &key: The registry key.
+*/
+static void release(const std::string &key) {
+	AssetLock lock;
+	auto found = registry.find(key);
+	if (found == registry.end()) return;
+
+	if (found->second.references > 0) found->second.references--;
+	found->second.lastUse = registryClock++;
+	trimRegistry();
+}
+
+/*
+	Get an asset from the registry, starting to load it if needed.
+
+	AsyncAsset::Type type: The type of the asset.
+	const char *Path: The path to the file.
+	bool async: If loading in the background or not.
+*/
+static std::shared_ptr<AsyncAsset> acquire(AsyncAsset::Type type, const char *Path, bool async) {
+	AssetLock lock;
+	const std::string key = registryKey(type, Path);
+	auto found = registry.find(key);
+
+	if (found == registry.end() || found->second.asset->Failed()) {
+		std::shared_ptr<AsyncAsset> asset;
+
+		/* Other threads can't create the SpriteSheet / Font, so the main thread finishes it. */
+		if (async || prefetched.find(Path) != prefetched.end() || !onMainThread()) {
+			asset = queueAsset(type, Path);
+
+		} else {
+			asset = std::make_shared<AsyncAsset>(type, Path);
+			asset->Load(); // Right here, no need to go through the loader thread.
+		}
+
+		const int references = found == registry.end() ? 0 : found->second.references;
+		found = registry.insert_or_assign(key, RegistryEntry { asset, references, 0 }).first;
+	}
+
+	found->second.references++;
+	found->second.lastUse = registryClock++;
+	return found->second.asset;
+}
+
+/*
+	Get a SpriteSheet from the registry.
+
+	const char *Path: The path to the file.
+*/
+C2D_SpriteSheet Gui::acquireSheet(const char *Path) {
+	std::shared_ptr<AsyncAsset> asset = acquire(AsyncAsset::Type::Sheet, Path, false);
+	asset->Wait();
+
+	if (asset->Failed()) release(registryKey(AsyncAsset::Type::Sheet, Path));
+	return asset->Sheet();
+}
+
+/*
+	Get a Font from the registry.
+
+	const char *Path: The path to the file.
+*/
+C2D_Font Gui::acquireFont(const char *Path) {
+	std::shared_ptr<AsyncAsset> asset = acquire(AsyncAsset::Type::Font, Path, false);
+	asset->Wait();
+
+	if (asset->Failed()) release(registryKey(AsyncAsset::Type::Font, Path));
+	return asset->Font();
+}
+
+/*
+	Get a SpriteSheet from the registry, loading it in the background.
+
+	const char *Path: The path to the file.
+*/
+std::shared_ptr<AsyncAsset> Gui::acquireSheetAsync(const char *Path) { return acquire(AsyncAsset::Type::Sheet, Path, true); };
+
+/*
+	Get a Font from the registry, loading it in the background.
+
+	const char *Path: The path to the file.
+*/
+std::shared_ptr<AsyncAsset> Gui::acquireFontAsync(const char *Path) { return acquire(AsyncAsset::Type::Font, Path, true); };
+
+/*
+	Release an asset, which got acquired in the background.
+
+	const std::shared_ptr<AsyncAsset> &asset: The handle of the asset.
+*/
+void Gui::releaseAsset(const std::shared_ptr<AsyncAsset> &asset) {
+	if (asset) release(registryKey(asset->GetType(), asset->Path().c_str()));
+}
+
+/*
+	Release an acquired SpriteSheet.
+
+	C2D_SpriteSheet sheet: The SpriteSheet.
+*/
+bool Gui::releaseSheet(C2D_SpriteSheet sheet) {
+	AssetLock lock;
+
+	for (auto &entry : registry) {
+		if (entry.second.asset->GetType() == AsyncAsset::Type::Sheet && entry.second.asset->Sheet() == sheet) {
+			release(std::string(entry.first)); // The entry might get free'd.
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+	Release an acquired Font.
+
+	C2D_Font fnt: The Font.
+*/
+bool Gui::releaseFont(C2D_Font fnt) {
+	AssetLock lock;
+
+	for (auto &entry : registry) {
+		if (entry.second.asset->GetType() == AsyncAsset::Type::Font && entry.second.asset->Font() == fnt) {
+			release(std::string(entry.first)); // The entry might get free'd.
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+	Set the budget for unreferenced assets.
+
+	size_t bytes: The budget in bytes.
+*/
+void Gui::setAssetBudget(size_t bytes) {
+	AssetLock lock;
+	assetBudget = bytes;
+	trimRegistry();
+}
+
+/*
+	Get information about all resident assets.
+*/
+std::vector<Gui::AssetInfo> Gui::getAssetInfo(void) {
+	AssetLock lock;
+	std::vector<Gui::AssetInfo> info;
+
+	for (auto &entry : registry) info.push_back({ entry.second.asset->Path(), entry.second.asset->Bytes(), entry.second.references });
+	return info;
+}
+
+/*
+	Finish the assets read in the background, free the SpriteSheets / Fonts other threads dropped and trim the registry.
+	Only on the main thread.
+*/
+void Gui::finishAssets(void) {
+	if (!onMainThread()) return;
+
+	std::vector<std::shared_ptr<AsyncAsset>> assets;
+	std::vector<C2D_SpriteSheet> sheets;
+	std::vector<C2D_Font> fonts;
+
+	LightLock_Lock(&queueLock);
+	assets.swap(readAssets);
+	sheets.swap(droppedSheets);
+	fonts.swap(droppedFonts);
+	LightLock_Unlock(&queueLock);
+
+	AssetLock lock;
+	for (const std::shared_ptr<AsyncAsset> &asset : assets) asset->Ready();
+	for (C2D_SpriteSheet sheet : sheets) C2D_SpriteSheetFree(sheet);
+	for (C2D_Font fnt : fonts) freeFont(fnt);
+	trimRegistry();
+}
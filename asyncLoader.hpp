@@ -0,0 +1,244 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_ASYNC_LOADER_HPP
+#define _UNIVERSAL_CORE_ASYNC_LOADER_HPP
+
+#include <3ds.h>
+#include <atomic>
+#include <citro2d.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+	A SpriteSheet or Font, which gets loaded in the background.
+
+	The file is read on the loader thread, the SpriteSheet or Font itself gets created on the main thread,
+	by the first 'Ready', 'Wait', 'Sheet' or 'Font' on it after the file got read, or by the next 'Gui::finishAssets'.
+	Synchronous loads through 'Gui::acquireSheet' / 'Gui::acquireFont' skip the loader thread and load straight from the path.
+	The loader functions may be called from other threads too, like the factory of 'Gui::setScreenDeferred'.
+	citro2d objects are only ever created and free'd on the main thread though: other threads always load through the loader thread,
+	their 'Wait' blocks until the main thread finished the asset, and an asset free'd on another thread leaves its SpriteSheet / Font
+	to the next 'Gui::finishAssets'. The asset gets free'd with the last handle.
+*/
+class AsyncAsset {
+public:
+	enum class Type : u8 { Sheet, Font };
+	enum class State : u8 { Queued, Read, Ready, Failed };
+
+	AsyncAsset(Type type, const std::string &path);
+	~AsyncAsset();
+	AsyncAsset(const AsyncAsset &) = delete;
+	AsyncAsset &operator=(const AsyncAsset &) = delete;
+
+	/*
+		Return if the asset got loaded. Never blocks.
+	*/
+	bool Ready();
+
+	/*
+		Return if the file couldn't be loaded.
+	*/
+	bool Failed() const { return this->state == State::Failed; };
+
+	/*
+		Block until the asset is loaded or failed.
+		On other threads than the main thread, this needs the main thread to keep calling 'Gui::clearTextBufs'.
+	*/
+	void Wait();
+
+	/*
+		Return the SpriteSheet / Font, or nullptr if it isn't ready (yet).
+	*/
+	C2D_SpriteSheet Sheet() { return this->Ready() ? this->sheet : nullptr; };
+	C2D_Font Font() { return this->Ready() ? this->font : nullptr; };
+
+	/*
+		Return if the asset is a SpriteSheet or a Font.
+	*/
+	Type GetType() const { return this->type; };
+
+	/*
+		Return how far the asset got loaded.
+	*/
+	State GetState() const { return this->state; };
+
+	/*
+		Return the path of the file.
+	*/
+	const std::string &Path() const { return this->path; };
+
+	/*
+		Return the size of the file in bytes, once it got read.
+		For SpriteSheets, the size of their textures once they're ready.
+	*/
+	size_t Bytes() const { return this->bytes; };
+
+	/* Used by the loader thread. */
+	void Read();
+	void Cancel();
+
+	/* Used by the registry for synchronous loads. */
+	void Load();
+private:
+	void Finish();
+	void CountTextureBytes();
+
+	Type type;
+	std::string path;
+	std::atomic<State> state;
+	LightEvent read, done; // The file got read / the asset is ready or failed.
+	std::vector<u8> data;
+	size_t bytes = 0;
+	C2D_SpriteSheet sheet = nullptr;
+	C2D_Font font = nullptr;
+};
+
+namespace Gui {
+	/*
+		Start loading a SpriteSheet in the background.
+		Returns the prefetched handle, if 'prefetchSheet' got called for the same path.
+
+		Path: Path to the SpriteSheet file. (T3X)
+	*/
+	std::shared_ptr<AsyncAsset> loadSheetAsync(const char *Path);
+
+	/*
+		Start loading a Font in the background.
+		Returns the prefetched handle, if 'prefetchFont' got called for the same path.
+
+		Path: Path to the BCFNT file.
+	*/
+	std::shared_ptr<AsyncAsset> loadFontAsync(const char *Path);
+
+	/*
+		Prefetch a SpriteSheet / Font, for example for the next screen while the current one is still shown.
+		The next 'loadSheetAsync' / 'loadFontAsync' with the same path takes it over.
+
+		Path: Path to the file.
+	*/
+	void prefetchSheet(const char *Path);
+	void prefetchFont(const char *Path);
+
+	/*
+		Drop all prefetched assets, which didn't get taken over.
+	*/
+	void clearPrefetched(void);
+
+	/*
+		Draw a sprite from a SpriteSheet, which gets loaded in the background.
+		Draws the placeholder sprite (or nothing, if there's none) while the SpriteSheet isn't ready.
+
+		sheet: The handle of the SpriteSheet.
+		imgIndex: The index of the sprite from the sheet which should be drawn.
+		x: The X Position where the sprite should be drawn.
+		y: The Y Position where the sprite should be drawn.
+		ScaleX: The X-Scale for the sprite. (Optional!)
+		ScaleY: The Y-Scale for the sprite. (Optional!)
+	*/
+	void DrawSprite(const std::shared_ptr<AsyncAsset> &sheet, size_t imgindex, int x, int y, float ScaleX = 1, float ScaleY = 1);
+
+	/*
+		Set the sprite, which gets drawn while a SpriteSheet isn't ready yet.
+
+		sheet: The SpriteSheet of the placeholder. nullptr draws nothing.
+		imgIndex: The index of the placeholder sprite.
+	*/
+	void setAsyncPlaceholder(C2D_SpriteSheet sheet, size_t imgindex);
+
+	/*
+		Create the SpriteSheets / Fonts read in the background and free the ones, which got dropped on other threads.
+		Also frees unreferenced assets over the budget, which got released on other threads.
+		Only does something on the main thread. 'Gui::clearTextBufs' calls this every frame.
+	*/
+	void finishAssets(void);
+
+	/*
+		Stop the loader thread. 'Gui::exit' does this for you.
+		Queued assets, which didn't get read yet, fail. Acquired assets stay loaded until they get released.
+	*/
+	void stopAsyncLoader(void);
+
+	/*
+		Information about an asset in the registry.
+	*/
+	struct AssetInfo {
+		std::string path;
+		size_t bytes; // Resident bytes. (Texture memory for SpriteSheets, the file size for Fonts.)
+		int references;
+	};
+
+	/*
+		Get a SpriteSheet / Font from the asset registry, loading it only if it isn't resident yet.
+		Every acquire needs a matching release. 'loadSheet' and 'loadFont' go through here as well.
+
+		Path: Path to the file.
+		Returns nullptr, if the file couldn't be loaded.
+	*/
+	C2D_SpriteSheet acquireSheet(const char *Path);
+	C2D_Font acquireFont(const char *Path);
+
+	/*
+		Same as 'acquireSheet' / 'acquireFont', but loading in the background.
+		Release it with 'releaseAsset'. The handle may outlive the registry entry, dropping it doesn't release it.
+
+		Path: Path to the file.
+	*/
+	std::shared_ptr<AsyncAsset> acquireSheetAsync(const char *Path);
+	std::shared_ptr<AsyncAsset> acquireFontAsync(const char *Path);
+
+	/*
+		Release an asset acquired with 'acquireSheetAsync' / 'acquireFontAsync'.
+		Without references left, it stays resident as long as the budget allows.
+
+		asset: The handle of the asset.
+	*/
+	void releaseAsset(const std::shared_ptr<AsyncAsset> &asset);
+
+	/*
+		Release an acquired SpriteSheet / Font.
+		Without references left, it stays resident as long as the budget allows.
+
+		Returns false, if it doesn't come from the registry.
+	*/
+	bool releaseSheet(C2D_SpriteSheet sheet);
+	bool releaseFont(C2D_Font fnt);
+
+	/*
+		Set how many bytes unreferenced assets may use, before the least recently used ones get free'd.
+
+		bytes: The budget. 0 frees assets as soon as they aren't referenced anymore. (Default.)
+	*/
+	void setAssetBudget(size_t bytes);
+
+	/*
+		Get information about all resident assets.
+	*/
+	std::vector<AssetInfo> getAssetInfo(void);
+};
+
+#endif
@@ -0,0 +1,193 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifdef UC_BENCHMARK
+
+#include "benchmark.hpp"
+#include "gui.hpp"
+#include "screenCommon.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+
+static size_t allocations = 0;
+
+void *operator new(size_t size) {
+	allocations++;
+
+	void *ptr = malloc(size ? size : 1);
+	if (!ptr) abort();
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
+
+class BenchmarkScreen : public Screen {
+public:
+#ifdef UC_KEY_REPEAT
+	void Logic(u32, u32, u32, touchPosition) override { };
+#else
+	void Logic(u32, u32, touchPosition) override { };
+#endif
+	void Draw() const override { };
+};
+
+/*
+	Run one benchmark.
+
+	const char *name: The name of the benchmark.
+	u32 iterations: How often 'op' runs.
+	u32 objects: The citro2d objects (quads) one 'op' draws, 0 if it doesn't draw. Drawing ones run inside of frames on the bottom screen.
+	const std::function<void()> &op: The operation.
+*/
+static Benchmark::Result measure(const char *name, u32 iterations, u32 objects, const std::function<void()> &op) {
+	/* citro2d drops everything past its object limit in a frame, so only run as many ops per frame as fit. */
+	const u32 opsPerFrame = objects ? std::max<u32>(C2D_DEFAULT_MAX_OBJECTS / objects, 1) : C2D_DEFAULT_MAX_OBJECTS;
+	const bool draws = objects > 0;
+	u64 ticks = 0;
+	size_t allocs = 0;
+
+	for (u32 done = 0; done < iterations;) {
+		const u32 count = std::min(opsPerFrame, iterations - done);
+
+		if (draws) {
+			C3D_FrameBegin(C3D_FRAME_SYNCDRAW);
+			Gui::ScreenDraw(Bottom);
+		}
+
+		const size_t allocsBefore = allocations;
+		const u64 start = svcGetSystemTick();
+		for (u32 i = 0; i < count; i++) op();
+		ticks += svcGetSystemTick() - start;
+		allocs += allocations - allocsBefore;
+
+		if (draws) {
+			Gui::flushSpriteBatch();
+			C3D_FrameEnd(0);
+		}
+
+		Gui::clearTextBufs();
+		done += count;
+	}
+
+	return { name, (double)ticks * 1000000000.0 / SYSCLOCK_ARM11 / iterations, (double)allocs / iterations, 0 };
+}
+
+/*
+	Read the ns_per_op values out of an earlier JSON file.
+
+	const std::string &path: The path of the file.
+	std::vector<Benchmark::Result> &results: The results to fill in the baseline for.
+*/
+static void readBaseline(const std::string &path, std::vector<Benchmark::Result> &results) {
+	FILE *file = fopen(path.c_str(), "r");
+	if (!file) return;
+
+	std::string json;
+	char chunk[512];
+	size_t read;
+	while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) json.append(chunk, read);
+	fclose(file);
+
+	for (Benchmark::Result &result : results) {
+		/* The whole quoted name followed by its comma, so "DrawString" doesn't match "DrawString maxWidth maxHeight". */
+		const size_t name = json.find("\"name\": \"" + result.name + "\",");
+		if (name == std::string::npos) continue;
+
+		/* Only look inside of this entry. */
+		const size_t end = json.find('}', name);
+		const size_t value = json.find("\"ns_per_op\": ", name);
+		if (value != std::string::npos && value < end) result.baselineNsPerOp = strtod(json.c_str() + value + 13, nullptr);
+	}
+}
+
+/*
+	Run all benchmarks and write the results as JSON.
+
+	const std::string &jsonPath: The path of the JSON file to write.
+	const std::string &baselinePath: A JSON file of an earlier run to compare with.
+	C2D_SpriteSheet sheet: A SpriteSheet for the DrawSprite benchmark.
+	u32 iterations: How often every benchmark runs.
+*/
+std::vector<Benchmark::Result> Benchmark::run(const std::string &jsonPath, const std::string &baselinePath, C2D_SpriteSheet sheet, u32 iterations) {
+	const u32 white = C2D_Color32(255, 255, 255, 255), black = C2D_Color32(0, 0, 0, 255);
+	const std::string text = "Universal-Core Benchmark 123";
+	const u32 glyphs = text.size(); // Every glyph is one object, the text is ASCII only.
+	std::vector<Benchmark::Result> results;
+
+	results.push_back(measure("DrawString", iterations, glyphs, [&]() { Gui::DrawString(10, 10, 0.5f, white, text); }));
+	results.push_back(measure("DrawString maxWidth maxHeight", iterations, glyphs, [&]() { Gui::DrawString(10, 10, 0.5f, white, text, 100, 10); }));
+
+	/* Without the Text Cache, every DrawString parses its Text again. */
+	const size_t textCacheSize = Gui::getTextCacheSize();
+	Gui::setTextCacheSize(0);
+	results.push_back(measure("DrawString uncached", iterations, glyphs, [&]() { Gui::DrawString(10, 10, 0.5f, white, text); }));
+	results.push_back(measure("DrawString maxWidth maxHeight uncached", iterations, glyphs, [&]() { Gui::DrawString(10, 10, 0.5f, white, text, 100, 10); }));
+	Gui::setTextCacheSize(textCacheSize);
+
+	results.push_back(measure("GetStringWidth", iterations, 0, [&]() { Gui::GetStringWidth(0.5f, text); }));
+	if (sheet) results.push_back(measure("DrawSprite", iterations, 1, [&]() { Gui::DrawSprite(sheet, 0, 10, 10); }));
+	results.push_back(measure("Draw_Rect", iterations, 1, [&]() { Gui::Draw_Rect(10, 10, 50, 50, white); }));
+	results.push_back(measure("drawGrid", iterations, 5, [&]() { Gui::drawGrid(10, 10, 50, 50, white, black); })); // The background and 4 lines.
+	results.push_back(measure("drawAnimatedSelector", iterations, 5, [&]() { Gui::drawAnimatedSelector(10, 10, 50, 50, 0.03f, white, black); }));
+	results.push_back(measure("fadeEffects", iterations, 0, []() { Gui::fadeEffects(); }));
+	results.push_back(measure("setScreen screenBack", iterations, 0, []() {
+		Gui::setScreen(std::make_unique<BenchmarkScreen>(), false, true);
+		Gui::screenBack();
+	}));
+
+	if (!baselinePath.empty()) readBaseline(baselinePath, results);
+
+	FILE *file = fopen(jsonPath.c_str(), "w");
+	if (file) {
+		fputs("{\n\t\"benchmarks\": [\n", file);
+
+		for (size_t i = 0; i < results.size(); i++) {
+			const Benchmark::Result &result = results[i];
+			fprintf(file, "\t\t{ \"name\": \"%s\", \"ns_per_op\": %.1f, \"allocs_per_op\": %.3f", result.name.c_str(), result.nsPerOp, result.allocsPerOp);
+
+			if (result.baselineNsPerOp > 0) {
+				fprintf(file, ", \"baseline_ns_per_op\": %.1f, \"change_percent\": %.1f", result.baselineNsPerOp,
+					(result.nsPerOp - result.baselineNsPerOp) * 100.0 / result.baselineNsPerOp);
+			}
+
+			fputs(i + 1 < results.size() ? " },\n" : " }\n", file);
+		}
+
+		fputs("\t]\n}\n", file);
+		fclose(file);
+	}
+
+	return results;
+}
+
+#endif
@@ -0,0 +1,65 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_BENCHMARK_HPP
+#define _UNIVERSAL_CORE_BENCHMARK_HPP
+
+#ifdef UC_BENCHMARK
+
+#include <citro2d.h>
+#include <string>
+#include <vector>
+
+/*
+	Microbenchmarks of the Gui hot paths. (Optional!)
+
+	Only compiled in with UC_BENCHMARK defined. This replaces the global operator new to count the allocations,
+	so only define it for benchmark builds. Run it after 'Gui::init', outside of a frame.
+	The DrawString benchmarks run with the Text Cache and without it, the latter measure the parsing of the Texts.
+	With the host layer, 'make benchmark' in 'host/' builds it as a PC program, to compare changes quickly before measuring on the console.
+*/
+namespace Benchmark {
+	struct Result {
+		std::string name;
+		double nsPerOp;
+		double allocsPerOp;
+		double baselineNsPerOp; // 0, if the baseline doesn't have this benchmark.
+	};
+
+	/*
+		Run all benchmarks and write the results as JSON.
+
+		jsonPath: The path of the JSON file to write.
+		baselinePath: A JSON file of an earlier run to compare with. (Optional!)
+		sheet: A SpriteSheet for the DrawSprite benchmark, which gets skipped without one. (Optional!)
+		iterations: How often every benchmark runs. (Optional!)
+	*/
+	std::vector<Result> run(const std::string &jsonPath, const std::string &baselinePath = "", C2D_SpriteSheet sheet = nullptr, u32 iterations = 4096);
+};
+
+#endif
+
+#endif
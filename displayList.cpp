@@ -0,0 +1,279 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "displayList.hpp"
+#include "gui.hpp"
+#include "screenCommon.hpp"
+
+DisplayList *DisplayList::recording = nullptr;
+float DisplayList::parallax = 0;
+
+DisplayList::~DisplayList() {
+	if (this->buf) C2D_TextBufDelete(this->buf);
+}
+
+/*
+	Remove all recorded draw calls.
+*/
+void DisplayList::Clear() {
+	this->commands.clear();
+	this->resources.clear();
+	if (this->buf) C2D_TextBufClear(this->buf);
+	this->valid = false;
+}
+
+/*
+	Clear the list and record the draw calls of 'draw' into it.
+
+	const std::function<void()> &draw: The drawing code.
+*/
+void DisplayList::Record(const std::function<void()> &draw) {
+	this->Clear();
+
+	DisplayList *previous = recording; // Allow recording inside of another recording.
+	recording = this;
+	this->silent = parallax > 0; // The eyes need different positions, so don't draw while recording.
+	draw();
+	Gui::flushSpriteBatch(); // Batched sprites belong to the list too.
+	this->silent = false;
+	recording = previous;
+
+	this->valid = true;
+	if (parallax > 0) this->Replay();
+}
+
+/*
+	Draw the recorded draw calls again.
+*/
+void DisplayList::Replay() const {
+	Gui::flushSpriteBatch(); // Queued sprites belong behind the list.
+
+	size_t first = 0;
+	for (size_t i = 1; i <= this->commands.size(); i++) {
+		if (i < this->commands.size() && this->commands[i].type != Type::Scene) continue;
+
+		/* Draw the scene [first, i), a Top scene once for every eye. Positive depths come out of the screen. */
+		if (parallax > 0 && this->commands[first].type == Type::Scene && this->commands[first].target == Top) {
+			this->ReplayCommands(first, i, parallax);
+			Gui::ScreenDraw(TopRight);
+			this->ReplayCommands(first + 1, i, -parallax);
+
+		} else {
+			this->ReplayCommands(first, i, 0);
+		}
+
+		first = i;
+	}
+}
+
+/*
+	Draw a range of the recorded draw calls.
+
+	size_t first: The first command.
+	size_t last: The command after the last one.
+	float offset: The X offset of a draw call with a depth of 1.
+*/
+void DisplayList::ReplayCommands(size_t first, size_t last, float offset) const {
+	size_t draws = 0;
+
+	for (size_t i = first; i < last; i++) {
+		const Command &cmd = this->commands[i];
+		const float x = cmd.x + cmd.depth * offset;
+		if (cmd.type != Type::Scene && cmd.type != Type::Clip) draws++;
+
+		switch(cmd.type) {
+			case Type::Scene:
+				Gui::ScreenDraw(cmd.target);
+				break;
+
+			case Type::Rect:
+				C2D_DrawRectSolid(x, cmd.y, 0.5f, cmd.w, cmd.h, cmd.color);
+#ifdef UC_DRAW_LOG
+				Gui::logDrawCommand({ Gui::DrawCommandType::Rect, x, cmd.y, cmd.w, cmd.h, cmd.color, nullptr, 0, "" });
+#endif
+				break;
+
+			case Type::Sprite:
+				C2D_DrawImageAt(cmd.image, x, cmd.y, 0.5f, nullptr, cmd.w, cmd.h);
+#ifdef UC_DRAW_LOG
+				Gui::logDrawCommand({ Gui::DrawCommandType::Sprite, x, cmd.y, cmd.w, cmd.h, 0, cmd.source, cmd.index, "" });
+#endif
+				break;
+
+			case Type::Text:
+				if (cmd.wrapWidth > 0) C2D_DrawText(&cmd.text, cmd.flags, x, cmd.y, 0.5f, cmd.w, cmd.h, cmd.color, cmd.wrapWidth);
+				else C2D_DrawText(&cmd.text, cmd.flags, x, cmd.y, 0.5f, cmd.w, cmd.h, cmd.color);
+#ifdef UC_DRAW_LOG
+				Gui::logDrawCommand({ Gui::DrawCommandType::Text, x, cmd.y, cmd.w, cmd.h, cmd.color, cmd.source, cmd.index, cmd.Text });
+#endif
+				break;
+
+			case Type::Clip:
+				if (cmd.flags) Gui::SetClip(x, cmd.y, cmd.w, cmd.h);
+				else Gui::ResetClip();
+				break;
+		}
+	}
+
+	Gui::countDraws(draws);
+}
+
+/*
+	Record a scene begin.
+
+	C3D_RenderTarget *target: The render target.
+*/
+void DisplayList::AddScene(C3D_RenderTarget *target) {
+	Command cmd = { };
+	cmd.type = Type::Scene;
+	cmd.target = target;
+	this->commands.push_back(cmd);
+}
+
+/*
+	Record a Rectangle.
+
+	float x: The X-Position.
+	float y: The Y-Position.
+	float w: The width.
+	float h: The height.
+	u32 color: The color.
+	float depth: The stereoscopic depth.
+*/
+void DisplayList::AddRect(float x, float y, float w, float h, u32 color, float depth) {
+	Command cmd = { };
+	cmd.type = Type::Rect;
+	cmd.x = x; cmd.y = y; cmd.w = w; cmd.h = h;
+	cmd.color = color;
+	cmd.depth = depth;
+	this->commands.push_back(cmd);
+}
+
+/*
+	Record a clip of 'Gui::SetClip', or the end of it.
+
+	bool enable: If clipping or not.
+	float x: The X-Position.
+	float y: The Y-Position.
+	float w: The width.
+	float h: The height.
+	float depth: The stereoscopic depth.
+*/
+void DisplayList::AddClip(bool enable, float x, float y, float w, float h, float depth) {
+	Command cmd = { };
+	cmd.type = Type::Clip;
+	cmd.x = x; cmd.y = y; cmd.w = w; cmd.h = h;
+	cmd.flags = enable;
+	cmd.depth = depth;
+	this->commands.push_back(cmd);
+}
+
+/*
+	Record a sprite.
+
+	C2D_Image image: The image of the sprite.
+	float x: The X-Position.
+	float y: The Y-Position.
+	float ScaleX: The X-Scale.
+	float ScaleY: The Y-Scale.
+	float depth: The stereoscopic depth.
+	const void *source: The SpriteSheet or cached widget, only kept for the draw log.
+	size_t index: The image index, only kept for the draw log.
+*/
+void DisplayList::AddSprite(C2D_Image image, float x, float y, float ScaleX, float ScaleY, float depth, const void *source, size_t index) {
+	Command cmd = { };
+	cmd.type = Type::Sprite;
+	cmd.x = x; cmd.y = y; cmd.w = ScaleX; cmd.h = ScaleY;
+	cmd.image = image;
+	cmd.depth = depth;
+#ifdef UC_DRAW_LOG
+	cmd.source = source;
+	cmd.index = index;
+#else
+	(void)source;
+	(void)index;
+#endif
+	this->commands.push_back(cmd);
+}
+
+/*
+	Record a Text. Unless it is parsed already, it gets parsed into the list's own Textbuffer.
+
+	const std::string &Text: The Text.
+	C2D_Font fnt: The Font. Must not be nullptr.
+	u32 flags: The C2D text flags, including C2D_WithColor.
+	float x: The X-Position.
+	float y: The Y-Position.
+	float ScaleX: The X-Scale.
+	float ScaleY: The Y-Scale.
+	u32 color: The Text Color.
+	float wrapWidth: The width for C2D_WordWrap, 0 if not wrapped.
+	float depth: The stereoscopic depth.
+	const C2D_Text *parsed: The parsed and optimized Text from the Text Cache, or nullptr.
+	const std::shared_ptr<void> &owner: Keeps the Textbuffer of 'parsed' valid.
+*/
+void DisplayList::AddText(const std::string &Text, C2D_Font fnt, u32 flags, float x, float y, float ScaleX, float ScaleY, u32 color, float wrapWidth, float depth, const C2D_Text *parsed, const std::shared_ptr<void> &owner) {
+	Command cmd = { };
+	cmd.type = Type::Text;
+	cmd.x = x; cmd.y = y; cmd.w = ScaleX; cmd.h = ScaleY;
+	cmd.color = color;
+	cmd.flags = flags;
+	cmd.wrapWidth = wrapWidth;
+	cmd.depth = depth;
+#ifdef UC_DRAW_LOG
+	cmd.source = fnt;
+	cmd.index = flags & ~C2D_WithColor; // The flags as passed to 'Gui::DrawString'.
+	cmd.Text = Text;
+#endif
+
+	/* Recording every frame, like in stereo mode, would otherwise parse every Text twice. */
+	if (parsed) {
+		cmd.text = *parsed;
+		this->Keep(owner);
+		this->commands.push_back(cmd);
+		return;
+	}
+
+	const size_t needed = (this->buf ? C2D_TextBufGetNumGlyphs(this->buf) : 0) + Text.size(); // A glyph never takes less than one byte.
+
+	if (needed > this->bufSize) {
+		const size_t newSize = std::max(this->bufSize * 2, std::max<size_t>(needed, 64));
+		C2D_TextBuf resized = this->buf ? C2D_TextBufResize(this->buf, newSize) : C2D_TextBufNew(newSize);
+		if (!resized) return;
+
+		/* The already parsed Texts still point to the old Textbuffer. */
+		for (Command &text : this->commands) {
+			if (text.type == Type::Text && text.text.buf == this->buf) text.text.buf = resized;
+		}
+
+		this->buf = resized;
+		this->bufSize = newSize;
+	}
+
+	C2D_TextFontParse(&cmd.text, fnt, this->buf, Text.c_str());
+	C2D_TextOptimize(&cmd.text);
+	this->commands.push_back(cmd);
+}
@@ -0,0 +1,152 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_DISPLAY_LIST_HPP
+#define _UNIVERSAL_CORE_DISPLAY_LIST_HPP
+
+#include <3ds.h>
+#include <citro2d.h>
+#include <citro3d.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+	A recorded list of draw calls, which can be replayed without running the drawing code again.
+
+	Only draws through the Gui namespace get recorded (ScreenDraw, Draw_Rect, DrawSprite, DrawString & co).
+	Texts get shared with the Text Cache, or parsed into the list's own Textbuffer, so replaying them costs no parsing at all.
+	Sprites keep pointing into their SpriteSheet, so invalidate the list before unloading a sheet it uses.
+	Cached widgets of 'Gui::drawCached' are kept alive by the list instead, until it gets recorded again or destroyed.
+
+	For stereoscopic 3D, every draw call keeps the depth set with 'Gui::setDepth'. With a parallax set,
+	the parts of the list drawn to the Top screen get replayed to both eyes, moved to the side by their depth.
+*/
+class DisplayList {
+public:
+	DisplayList() {}
+	~DisplayList();
+	DisplayList(const DisplayList &) = delete;
+	DisplayList &operator=(const DisplayList &) = delete;
+
+	/*
+		Clear the list and record the draw calls of 'draw' into it. They get drawn as well.
+		With a parallax set, they only get recorded first and then replayed, so both eyes get them.
+
+		draw: The drawing code.
+	*/
+	void Record(const std::function<void()> &draw);
+
+	/*
+		Draw the recorded draw calls again. With a parallax set, Top screen scenes get drawn to TopRight as well.
+	*/
+	void Replay() const;
+
+	/*
+		Mark the list as outdated, so that the next use records it again.
+	*/
+	void Invalidate() { this->valid = false; };
+
+	/*
+		Return if the list holds a finished recording.
+	*/
+	bool Valid() const { return this->valid; };
+
+	/*
+		Remove all recorded draw calls.
+	*/
+	void Clear();
+
+	/*
+		Return the list which is currently recording, or nullptr.
+	*/
+	static DisplayList *Recording() { return recording; };
+
+	/*
+		Pause the current recording, for draws which don't belong to it like offscreen rendering.
+		Returns the list to pass to 'Resume' afterwards.
+	*/
+	static DisplayList *Suspend() {
+		DisplayList *list = recording;
+		recording = nullptr;
+		return list;
+	};
+	static void Resume(DisplayList *list) { recording = list; };
+
+	/*
+		Return true, while a list records without drawing. The Gui namespace then skips its draw calls.
+	*/
+	static bool Silent() { return recording && recording->silent; };
+
+	/*
+		Set the parallax for stereoscopic replays, 0 to turn it off. Set by 'Gui::DrawScreen' in stereo mode.
+
+		parallax: The horizontal offset of a draw call with a depth of 1 for each eye, in pixels.
+	*/
+	static void SetParallax(float parallax) { DisplayList::parallax = parallax; };
+	static float Parallax() { return parallax; };
+
+	/* Used by the Gui namespace to record its draw calls. */
+	void AddScene(C3D_RenderTarget *target);
+	void AddRect(float x, float y, float w, float h, u32 color, float depth);
+	void AddSprite(C2D_Image image, float x, float y, float ScaleX, float ScaleY, float depth, const void *source, size_t index);
+	void AddText(const std::string &Text, C2D_Font fnt, u32 flags, float x, float y, float ScaleX, float ScaleY, u32 color, float wrapWidth, float depth, const C2D_Text *parsed, const std::shared_ptr<void> &owner);
+	void AddClip(bool enable, float x, float y, float w, float h, float depth);
+	void Keep(const std::shared_ptr<void> &resource) { this->resources.push_back(resource); };
+private:
+	enum class Type : u8 { Scene, Rect, Sprite, Text, Clip };
+
+	struct Command {
+		Type type;
+		float x, y, w, h; // Sprites and Texts store the scale in w and h.
+		u32 color;
+		u32 flags; // Texts: The C2D text flags, Clips: 1 to clip, 0 to stop.
+		float wrapWidth;
+		float depth;
+		C3D_RenderTarget *target;
+		C2D_Image image;
+		C2D_Text text;
+#ifdef UC_DRAW_LOG
+		const void *source; // The SpriteSheet, the cached widget or the Font.
+		size_t index; // The image index or the Text flags.
+		std::string Text;
+#endif
+	};
+
+	std::vector<Command> commands;
+	std::vector<std::shared_ptr<void>> resources; // Kept alive for the replays.
+	C2D_TextBuf buf = nullptr;
+	size_t bufSize = 0;
+	bool valid = false, silent = false;
+
+	void ReplayCommands(size_t first, size_t last, float offset) const;
+
+	static DisplayList *recording;
+	static float parallax;
+};
+
+#endif
@@ -24,17 +24,25 @@
 *         reasonable ways as different from the original version.
 */
 
+#include "animation.hpp"
+#include "asyncLoader.hpp"
+#include "displayList.hpp"
 #include "gui.hpp"
+#include "inputRecord.hpp"
+#include "profiler.hpp"
 #include "screenCommon.hpp"
 
 #include <3ds.h>
+#include <algorithm>
+#include <list>
+#include <memory>
 #include <stack>
-#include <unistd.h>
+#include <unordered_map>
 #include <vector>
 
 C3D_RenderTarget *Top, *TopRight, *Bottom;
 
-C2D_TextBuf TextBuf;
+C2D_TextBuf TextBuf, MeasureBuf;
 C2D_Font Font;
 std::unique_ptr<Screen> usedScreen, tempScreen; // tempScreen used for "fade" effects.
 std::stack<std::unique_ptr<Screen>> screens;
@@ -42,12 +50,575 @@ bool currentScreen = false;
 bool fadeout = false, fadein = false, fadeout2 = false, fadein2 = false;
 int fadealpha = 0;
 int fadecolor = 0;
+static Animation::Id fadeAnimation = 0;
+static int fadeDirection = 0; // 0: Fadeout, 1: Fadein.
+
+/* Stereoscopic 3D, see 'Gui::setStereo'. */
+static bool stereoEnabled = false;
+static float stereoMaxParallax = 0, drawDepth = 0;
+static u32 stereoClearColor = 0;
+static DisplayList stereoList;
+
+/* Deferred screen construction, see 'Gui::setScreenDeferred'. */
+static Thread screenBuilder = nullptr;
+static std::function<std::unique_ptr<Screen>()> screenFactory;
+static std::unique_ptr<Screen> builtScreen;
+static LightEvent screenBuilt;
+static void finishScreenBuild(void);
+
+/* Threaded logic, see 'Gui::setThreadedLogic'. */
+static void finishLogic(void);
+static bool onLogicThread(void);
+static std::vector<std::function<void()>> deferredActions; // Screen switches from the logic thread.
 CFG_Region loadedSystemFont = (CFG_Region)-1;
 
+/*
+	Wait on the main thread for another thread.
+	Meanwhile keep finishing the assets read in the background, the other thread might wait for one of them.
+
+	LightEvent *event: The event the other thread signals.
+*/
+static void waitOnMain(LightEvent *event) {
+	while (LightEvent_WaitTimeout(event, 1000000)) Gui::finishAssets();
+}
+
+#ifdef UC_DRAW_LOG
+/*
+	Draw log.
+
+	Every draw call through the Gui namespace gets recorded into 'drawLog', replayed DisplayLists through 'Gui::logDrawCommand'.
+	Draw calls which a DisplayList only records without drawing get logged once they are replayed.
+	'Gui::clearTextBufs' marks the end of a frame and moves it to 'lastDrawLog'.
+*/
+static std::vector<Gui::DrawCommand> drawLog, lastDrawLog;
+
+static void logDraw(Gui::DrawCommandType type, float x, float y, float w, float h, u32 color, const void *source = nullptr, size_t index = 0, const std::string &Text = "") {
+	if (!DisplayList::Silent()) drawLog.push_back({ type, x, y, w, h, color, source, index, Text });
+}
+
+/*
+	Add a draw command to the draw log.
+
+	const Gui::DrawCommand &command: The draw command.
+*/
+void Gui::logDrawCommand(const Gui::DrawCommand &command) { drawLog.push_back(command); };
+
+/*
+	Return the draw commands of the last finished frame.
+*/
+const std::vector<Gui::DrawCommand> &Gui::getDrawLog(void) { return lastDrawLog; };
+#endif
+
+/*
+	Glyph metrics.
+
+	Every Font gets a table of glyph advances, so Texts can be measured without parsing them into a Textbuffer.
+	The first 256 code points are looked up once when the table gets built, all others on first use.
+	'metricsLock' guards the tables, so Texts can also be measured from other threads.
+*/
+struct GlyphMetrics {
+	float advance[256];
+	std::unordered_map<u32, float> extra;
+	float lineHeight; // The line feed at scale 1.
+};
+
+static std::unordered_map<C2D_Font, GlyphMetrics> glyphMetrics;
+static LightLock metricsLock;
+
+static float glyphAdvance(C2D_Font fnt, u32 codepoint) {
+	fontGlyphPos_s glyph;
+	C2D_FontCalcGlyphPos(fnt, &glyph, C2D_FontGlyphIndexFromCodePoint(fnt, codepoint), 0, 1.0f, 1.0f);
+
+	return glyph.xAdvance;
+}
+
+/*
+	Return the glyph metrics of a Font, building them on first use.
+
+	C2D_Font fnt: The Font. Must not be nullptr.
+
+	Only call this with 'metricsLock' held.
+*/
+static GlyphMetrics &getGlyphMetrics(C2D_Font fnt) {
+	auto found = glyphMetrics.find(fnt);
+	if (found != glyphMetrics.end()) return found->second;
+
+	GlyphMetrics &metrics = glyphMetrics[fnt];
+	for (u32 codepoint = 0; codepoint < 256; codepoint++) metrics.advance[codepoint] = glyphAdvance(fnt, codepoint);
+
+	/* Take the line height from citro2d itself, at a big scale so the rounding doesn't matter. */
+	C2D_Text text;
+	float height = 0;
+	C2D_TextFontParse(&text, fnt, MeasureBuf, "0");
+	C2D_TextGetDimensions(&text, 1.0f, 100.0f, nullptr, &height);
+	C2D_TextBufClear(MeasureBuf);
+	metrics.lineHeight = height / 100.0f;
+
+	return metrics;
+}
+
+/*
+	Sprite batching.
+
+	While batching, 'Gui::DrawSprite' only queues the sprites. On flush they get sorted by texture,
+	but a sprite never moves in front of an overlapping sprite with another texture that was drawn after it.
+*/
+struct QueuedSprite {
+	C2D_Image image;
+	float x, y, ScaleX, ScaleY;
+	float left, top, right, bottom;
+	u32 level, order;
+	float depth;
+	const void *source; // The SpriteSheet or cached widget, for the draw log of DisplayList replays.
+	size_t index;
+};
+
+static std::vector<QueuedSprite> spriteBatch;
+static bool batchingSprites = false;
+static const C3D_Tex *lastSpriteTex = nullptr;
+static size_t spriteBatches = 0, textureBinds = 0, lastFrameBatches = 0, lastFrameBinds = 0;
+static size_t drawCount = 0, lastFrameDrawCount = 0; // Rectangles, sprites and Texts drawn through the Gui namespace or DisplayList replays.
+
+/*
+	Draw a sprite right away and count the texture switch.
+
+	const QueuedSprite &sprite: The sprite.
+*/
+static void submitSprite(const QueuedSprite &sprite) {
+	if (sprite.image.tex != lastSpriteTex) {
+		textureBinds++;
+		lastSpriteTex = sprite.image.tex;
+	}
+
+	if (!DisplayList::Silent()) {
+		drawCount++;
+		C2D_DrawImageAt(sprite.image, sprite.x, sprite.y, 0.5f, nullptr, sprite.ScaleX, sprite.ScaleY);
+	}
+
+	if (DisplayList::Recording()) DisplayList::Recording()->AddSprite(sprite.image, sprite.x, sprite.y, sprite.ScaleX, sprite.ScaleY, sprite.depth, sprite.source, sprite.index);
+}
+
+/*
+	Draw an image through the sprite batch, or right away when not batching.
+
+	C2D_Image image: The image.
+	float x: The X-Position.
+	float y: The Y-Position.
+	float ScaleX: The X-Scale.
+	float ScaleY: The Y-Scale.
+	const void *source: The SpriteSheet or cached widget the image is from.
+	size_t index: The image index in the SpriteSheet.
+*/
+static void queueImage(C2D_Image image, float x, float y, float ScaleX, float ScaleY, const void *source, size_t index) {
+	QueuedSprite sprite = { image, x, y, ScaleX, ScaleY, 0, 0, 0, 0, 0, 0, drawDepth, source, index };
+
+	if (!batchingSprites) {
+		submitSprite(sprite);
+		return;
+	}
+
+	const float w = sprite.image.subtex->width * ScaleX, h = sprite.image.subtex->height * ScaleY;
+	sprite.left = std::min(x + w, x);
+	sprite.right = std::max(x + w, x);
+	sprite.top = std::min(y + h, y);
+	sprite.bottom = std::max(y + h, y);
+	sprite.order = spriteBatch.size();
+
+	/* Stay above every overlapping sprite before, above other textures even one level higher. */
+	for (const QueuedSprite &below : spriteBatch) {
+		if (below.left < sprite.right && sprite.left < below.right && below.top < sprite.bottom && sprite.top < below.bottom) {
+			sprite.level = std::max(sprite.level, below.level + (below.image.tex != sprite.image.tex ? 1 : 0));
+		}
+	}
+
+	spriteBatch.push_back(sprite);
+}
+
+/*
+	Called before every draw, which isn't a sprite.
+	Submits the queued sprites, so they stay behind it, and forgets the bound texture.
+*/
+static void beforeOtherDraw(void) {
+	if (!spriteBatch.empty()) Gui::flushSpriteBatch();
+	lastSpriteTex = nullptr;
+}
+
+/*
+	Called before a draw, which isn't a sprite and only covers the given area.
+	The queued sprites only get submitted, if one of them overlaps it. Otherwise the order doesn't matter,
+	so the draw goes first and the queued sprites stay batched.
+
+	float left, top, right, bottom: The covered area.
+*/
+static void beforeOtherDraw(float left, float top, float right, float bottom) {
+	for (const QueuedSprite &sprite : spriteBatch) {
+		if (sprite.left < right && left < sprite.right && sprite.top < bottom && top < sprite.bottom) {
+			Gui::flushSpriteBatch();
+			break;
+		}
+	}
+
+	if (spriteBatch.empty()) lastSpriteTex = nullptr;
+}
+
+/*
+	Draw a Rectangle without flushing the sprite batch.
+	Used by all the Rectangle functions.
+*/
+static bool emitRect(float x, float y, float w, float h, u32 color) {
+	if (!DisplayList::Silent()) drawCount++;
+
+#ifdef UC_DRAW_LOG
+	logDraw(Gui::DrawCommandType::Rect, x, y, w, h, color);
+#endif
+
+	if (DisplayList::Recording()) DisplayList::Recording()->AddRect(x, y, w, h, color, drawDepth);
+
+	return DisplayList::Silent() || C2D_DrawRectSolid(x, y, 0.5f, w, h, color);
+}
+
+/*
+	Frame pacing.
+*/
+static bool pacingEnabled = false, redrawRequested = true;
+static int pacingIdleInterval = 0, pacingWakeFrames = 30, framesSinceInput = 0, idleFrames = 0;
+
+/*
+	Return the current screen or nullptr.
+
+	bool stack: If using the stack-screens or not.
+*/
+static Screen *getScreen(bool stack) {
+	if (!stack) return usedScreen.get();
+
+	return screens.empty() ? nullptr : screens.top().get();
+}
+
+/*
+	Cached widgets.
+
+	Every widget owns an offscreen texture with a render target, ordered by last use like the Text Cache.
+	The texture lives on the heap and is shared with the display lists which recorded it, so it stays where it is
+	while the cache reorders or drops its entry. Once the last owner lets it go, it may still be used by the frame
+	on the GPU, or by sprites citro2d didn't flush yet, so it only gets freed two frames later.
+*/
+struct WidgetTexture {
+	C3D_Tex tex;
+	Tex3DS_SubTexture subtex;
+	C3D_RenderTarget *target;
+};
+
+struct CachedWidget {
+	std::string key;
+	int width, height;
+	size_t bytes;
+	bool valid;
+	std::shared_ptr<WidgetTexture> texture;
+};
+
+static std::list<CachedWidget> widgetCache;
+static std::unordered_map<std::string, std::list<CachedWidget>::iterator> widgetCacheMap;
+static std::vector<WidgetTexture *> retiredWidgets, retiredWidgetsOld;
+static size_t widgetCacheBudget = 1024 * 1024, widgetCacheBytes = 0;
+static C3D_RenderTarget *sceneTarget = nullptr; // The target of the last 'Gui::ScreenDraw'.
+
+/* The clip of 'Gui::SetClip'. */
+static bool clipping = false;
+static Gui::Rect clipRect = { };
+
+/*
+	Set or turn off the GPU scissor. Only the screens get clipped.
+	They are rotated, so the scissor starts at the bottom left corner of the screen and its X goes along the height.
+
+	bool enable: If clipping or not.
+	float x, y, w, h: The clip Rectangle.
+*/
+static void applyClip(bool enable, float x, float y, float w, float h) {
+	clipping = enable;
+	clipRect = { x, y, w, h, 0 };
+	C2D_Flush(); // What got drawn before isn't clipped.
+
+	if (!enable || (sceneTarget != Top && sceneTarget != TopRight && sceneTarget != Bottom)) {
+		C3D_SetScissor(GPU_SCISSOR_DISABLE, 0, 0, 0, 0);
+		return;
+	}
+
+	const int width = currentScreen ? 400 : 320;
+	auto clamp = [](float value, int max) { return (u32)std::max(0, std::min((int)value, max)); };
+
+	C3D_SetScissor(GPU_SCISSOR_NORMAL, clamp(240 - (y + h), 240), clamp(width - (x + w), width), clamp(240 - y, 240), clamp(width - x, width));
+}
+
+/* The deleter of the shared textures. */
+static void retireTexture(WidgetTexture *texture) { retiredWidgets.push_back(texture); };
+
+static void retireWidget(std::list<CachedWidget>::iterator it) {
+	widgetCacheBytes -= it->bytes;
+	widgetCacheMap.erase(it->key);
+	widgetCache.erase(it);
+}
+
+static void freeRetiredWidgets(std::vector<WidgetTexture *> &retired) {
+	for (WidgetTexture *texture : retired) {
+		C3D_RenderTargetDelete(texture->target);
+		C3D_TexDelete(&texture->tex);
+		delete texture;
+	}
+
+	retired.clear();
+}
+
+/* Keeps the most recently used widget, even if it alone is above the budget. */
+static void trimWidgetCache(void) {
+	while (widgetCache.size() > 1 && widgetCacheBytes > widgetCacheBudget) retireWidget(std::prev(widgetCache.end()));
+}
+
+static u16 textureSize(int size) {
+	u16 texSize = 8; // The smallest texture size of the GPU.
+	while (texSize < size) texSize <<= 1;
+	return texSize;
+}
+
+/*
+	Textbuffer accounting.
+
+	The Textbuffer starts with 'textBufSize' glyphs and grows on demand up to 'textBufBudget' glyphs.
+	'Gui::clearTextBufs' marks the end of a frame for the usage statistics.
+	'textCacheGlyphs' counts the glyphs parsed into Text Cache entries this frame, they don't go through the Textbuffer.
+*/
+static size_t textBufSize = 4096, textBufBudget = 8192;
+static size_t textBufLastFrame = 0, textBufPeak = 0, textBufDropped = 0, textCacheGlyphs = 0;
+
+/*
+	Parse a Text into the Textbuffer, growing it first if the Text wouldn't fit anymore.
+
+	C2D_Text *text: The C2D_Text to parse into.
+	C2D_Font fnt: The Font to use.
+	std::string Text: The Text.
+*/
+static void parseIntoTextBuf(C2D_Text *text, C2D_Font fnt, const std::string &Text) {
+	const size_t needed = C2D_TextBufGetNumGlyphs(TextBuf) + Text.size(); // A glyph never takes less than one byte.
+
+	if (needed > textBufSize && textBufSize < textBufBudget) {
+		const size_t newSize = std::min(textBufBudget, std::max(textBufSize * 2, needed));
+
+		/* Already drawn Texts are not affected, C2D_DrawText copies the glyphs out right away. */
+		C2D_TextBuf resized = C2D_TextBufResize(TextBuf, newSize);
+		if (resized) {
+			TextBuf = resized;
+			textBufSize = newSize;
+		}
+	}
+
+	const char *end = C2D_TextFontParse(text, fnt, TextBuf, Text.c_str());
+	Profiler::addGlyphs(text->end - text->begin);
+	if (end && *end) textBufDropped += Text.size() - (end - Text.c_str()); // The Textbuffer is full.
+}
+
+/*
+	Text Cache.
+
+	Keeps parsed and optimized C2D_Texts across frames, so labels which are drawn every frame only get parsed once.
+	Every entry owns its own Textbuffer, so it survives 'Gui::clearTextBufs' and can be freed on its own.
+	Display lists share the Textbuffer of the Texts they record, so they don't need to parse them again.
+	The entries are ordered by last use, the front is the most recently used one.
+*/
+struct TextCacheEntry {
+	std::string Text;
+	C2D_Font fnt;
+	size_t hash;
+	std::shared_ptr<C2D_TextBuf_s> buf;
+	C2D_Text text;
+};
+
+static std::list<TextCacheEntry> textCache;
+static std::unordered_map<size_t, std::list<TextCacheEntry>::iterator> textCacheMap;
+static size_t textCacheSize = 128, textCacheHits = 0, textCacheMisses = 0;
+
+static size_t textCacheHash(const std::string &Text, C2D_Font fnt) {
+	const size_t hash = std::hash<std::string>()(Text);
+	return hash ^ (std::hash<C2D_Font>()(fnt) + 0x9E3779B9 + (hash << 6) + (hash >> 2));
+}
+
+static void textCacheErase(std::list<TextCacheEntry>::iterator it) {
+	textCacheMap.erase(it->hash);
+	textCache.erase(it);
+}
+
+/*
+	Return the parsed and optimized Text, either from the Text Cache or freshly parsed.
+
+	C2D_Text &scratch: The C2D_Text to parse into, if the cache is disabled.
+	std::string Text: The Text.
+	C2D_Font fnt: The Font to use. Must not be nullptr.
+	std::shared_ptr<void> &owner: Gets the Textbuffer of a cached Text, which keeps it valid. Empty, if the cache is disabled.
+
+	The returned pointer is only valid until the next call.
+*/
+static const C2D_Text *getText(C2D_Text &scratch, const std::string &Text, C2D_Font fnt, std::shared_ptr<void> &owner) {
+	if (textCacheSize == 0) {
+		parseIntoTextBuf(&scratch, fnt, Text);
+		C2D_TextOptimize(&scratch);
+		return &scratch;
+	}
+
+	const size_t hash = textCacheHash(Text, fnt);
+	auto found = textCacheMap.find(hash);
+
+	if (found != textCacheMap.end()) {
+		if (found->second->fnt == fnt && found->second->Text == Text) {
+			textCacheHits++;
+			textCache.splice(textCache.begin(), textCache, found->second); // Mark as most recently used.
+			owner = textCache.front().buf;
+			return &textCache.front().text;
+		}
+
+		textCacheErase(found->second); // Hash collision, replace the old entry.
+	}
+
+	textCacheMisses++;
+	while (textCache.size() >= textCacheSize) textCacheErase(std::prev(textCache.end()));
+
+	/* A glyph never takes less than one byte, so the string length is always enough. */
+	textCache.push_front({ Text, fnt, hash, std::shared_ptr<C2D_TextBuf_s>(C2D_TextBufNew(std::max<size_t>(Text.size(), 1)), C2D_TextBufDelete), C2D_Text() });
+	TextCacheEntry &entry = textCache.front();
+	C2D_TextFontParse(&entry.text, fnt, entry.buf.get(), Text.c_str());
+	textCacheGlyphs += entry.text.end - entry.text.begin;
+	Profiler::addGlyphs(entry.text.end - entry.text.begin);
+	C2D_TextOptimize(&entry.text);
+	textCacheMap[hash] = textCache.begin();
+
+	owner = entry.buf;
+	return &entry.text;
+}
+
+/*
+	Set the maximum amount of entries in the Text Cache.
+
+	size_t entries: The maximum amount of entries. 0 disables the cache.
+*/
+void Gui::setTextCacheSize(size_t entries) {
+	textCacheSize = entries;
+	while (textCache.size() > textCacheSize) textCacheErase(std::prev(textCache.end()));
+}
+
+/*
+	Return the maximum amount of entries in the Text Cache.
+*/
+size_t Gui::getTextCacheSize(void) { return textCacheSize; };
+
+/*
+	Clear the whole Text Cache.
+*/
+void Gui::clearTextCache(void) {
+	while (!textCache.empty()) textCacheErase(textCache.begin());
+
+	LightLock_Lock(&metricsLock);
+	glyphMetrics.clear();
+	LightLock_Unlock(&metricsLock);
+}
+
+/*
+	Drop all cached Texts and glyph metrics of a Font.
+
+	C2D_Font fnt: The Font. nullptr means the loaded system font.
+*/
+void Gui::invalidateTextCache(C2D_Font fnt) {
+	if (!fnt) fnt = Font;
+
+	LightLock_Lock(&metricsLock);
+	glyphMetrics.erase(fnt);
+	LightLock_Unlock(&metricsLock);
+
+	for (auto it = textCache.begin(); it != textCache.end();) {
+		if (it->fnt == fnt) textCacheErase(it++);
+		else ++it;
+	}
+}
+
+/*
+	Get the Text Cache counters.
+
+	size_t *hits: Pointer where to store the amount of hits. (Optional!)
+	size_t *misses: Pointer where to store the amount of misses. (Optional!)
+*/
+void Gui::getTextCacheStats(size_t *hits, size_t *misses) {
+	if (hits) *hits = textCacheHits;
+	if (misses) *misses = textCacheMisses;
+}
+
+/*
+	Reset the Text Cache counters.
+*/
+void Gui::resetTextCacheStats(void) { textCacheHits = textCacheMisses = 0; };
+
 /*
 	Clear the Text Buffer.
 */
-void Gui::clearTextBufs(void) { C2D_TextBufClear(TextBuf); };
+void Gui::clearTextBufs(void) {
+	textBufLastFrame = C2D_TextBufGetNumGlyphs(TextBuf) + textCacheGlyphs;
+	textBufPeak = std::max(textBufPeak, textBufLastFrame);
+	textCacheGlyphs = 0;
+
+	C2D_TextBufClear(TextBuf);
+
+	lastFrameBatches = spriteBatches;
+	lastFrameBinds = textureBinds;
+	spriteBatches = textureBinds = 0;
+
+	lastFrameDrawCount = drawCount;
+	drawCount = 0;
+
+	freeRetiredWidgets(retiredWidgetsOld);
+	retiredWidgetsOld.swap(retiredWidgets);
+	Gui::finishAssets();
+
+#ifdef UC_DRAW_LOG
+	lastDrawLog.swap(drawLog);
+	drawLog.clear();
+#endif
+
+	Profiler::endFrame();
+};
+
+/*
+	Return the amount of Rectangles, sprites and Texts drawn in the last frame.
+*/
+size_t Gui::getDrawCount(void) { return lastFrameDrawCount; };
+
+/*
+	Count draws, which didn't go through the Gui namespace.
+
+	size_t count: The amount of draws.
+*/
+void Gui::countDraws(size_t count) { drawCount += count; };
+
+/*
+	Set the glyph budget of the Textbuffer.
+
+	size_t maxGlyphs: The maximum amount of glyphs the Textbuffer may grow to.
+*/
+void Gui::setTextBufBudget(size_t maxGlyphs) { textBufBudget = maxGlyphs; };
+
+/*
+	Get the Textbuffer statistics.
+
+	size_t *lastFrame: Pointer where to store the glyphs parsed in the last frame, including Text Cache misses. (Optional!)
+	size_t *peak: Pointer where to store the most glyphs parsed in a frame, including Text Cache misses. (Optional!)
+	size_t *capacity: Pointer where to store the current size of the Textbuffer. (Optional!)
+	size_t *dropped: Pointer where to store the amount of glyphs which didn't fit. (Optional!)
+*/
+void Gui::getTextBufStats(size_t *lastFrame, size_t *peak, size_t *capacity, size_t *dropped) {
+	if (lastFrame) *lastFrame = textBufLastFrame;
+	if (peak) *peak = textBufPeak;
+	if (capacity) *capacity = textBufSize;
+	if (dropped) *dropped = textBufDropped;
+}
+
+/*
+	Reset the Textbuffer statistics.
+*/
+void Gui::resetTextBufStats(void) { textBufLastFrame = textBufPeak = textBufDropped = 0; };
 
 /*
 	Draw a sprite from the sheet.
@@ -62,11 +633,170 @@ void Gui::clearTextBufs(void) { C2D_TextBufClear(TextBuf); };
 	If the spritesheet is nullptr or image index goes out of scope, this doesn't do anything.
 */
 void Gui::DrawSprite(C2D_SpriteSheet sheet, size_t imgindex, int x, int y, float ScaleX, float ScaleY) {
+	UC_PROFILE(DrawSprite);
+
 	if (sheet) {
-		if (C2D_SpriteSheetCount(sheet) >= imgindex) {
-			C2D_DrawImageAt(C2D_SpriteSheetGetImage(sheet, imgindex), x, y, 0.5f, nullptr, ScaleX, ScaleY);
+		if (C2D_SpriteSheetCount(sheet) > imgindex) {
+#ifdef UC_DRAW_LOG
+			logDraw(Gui::DrawCommandType::Sprite, x, y, ScaleX, ScaleY, 0, sheet, imgindex);
+#endif
+
+			queueImage(C2D_SpriteSheetGetImage(sheet, imgindex), x, y, ScaleX, ScaleY, sheet, imgindex);
+		}
+	}
+}
+
+/*
+	Start queueing sprites from 'DrawSprite'.
+*/
+void Gui::beginSpriteBatch(void) { batchingSprites = true; };
+
+/*
+	Submit the queued sprites and stop queueing.
+*/
+void Gui::endSpriteBatch(void) {
+	Gui::flushSpriteBatch();
+	batchingSprites = false;
+}
+
+/*
+	Submit the queued sprites, sorted by texture.
+*/
+void Gui::flushSpriteBatch(void) {
+	if (spriteBatch.empty()) return;
+
+	std::sort(spriteBatch.begin(), spriteBatch.end(), [](const QueuedSprite &a, const QueuedSprite &b) {
+		if (a.level != b.level) return a.level < b.level;
+		if (a.image.tex != b.image.tex) return a.image.tex < b.image.tex;
+		return a.order < b.order;
+	});
+
+	for (const QueuedSprite &sprite : spriteBatch) submitSprite(sprite);
+
+	spriteBatch.clear();
+	spriteBatches++;
+}
+
+/*
+	Get the sprite statistics of the last frame.
+
+	size_t *batches: Pointer where to store the amount of submitted batches. (Optional!)
+	size_t *binds: Pointer where to store the amount of texture switches between sprites. (Optional!)
+*/
+void Gui::getSpriteStats(size_t *batches, size_t *binds) {
+	if (batches) *batches = lastFrameBatches;
+	if (binds) *binds = lastFrameBinds;
+}
+
+/*
+	Draw a widget from its cached texture, rendering it first if needed.
+
+	const std::string &key: The name of the widget.
+	float x: The X-Position where to draw.
+	float y: The Y-Position where to draw.
+	int w: The width of the widget.
+	int h: The height of the widget.
+	const std::function<void()> &draw: Draws the widget, with 0, 0 as its top left corner.
+*/
+bool Gui::drawCached(const std::string &key, float x, float y, int w, int h, const std::function<void()> &draw) {
+	if (w <= 0 || h <= 0 || w > 1024 || h > 1024) return false;
+
+	auto found = widgetCacheMap.find(key);
+	if (found != widgetCacheMap.end() && (found->second->width != w || found->second->height != h)) {
+		retireWidget(found->second);
+		found = widgetCacheMap.end();
+	}
+
+	if (found == widgetCacheMap.end()) {
+		const u16 texW = textureSize(w), texH = textureSize(h);
+		std::unique_ptr<WidgetTexture> texture(new WidgetTexture());
+
+		if (!C3D_TexInitVRAM(&texture->tex, texW, texH, GPU_RGBA8)) return false;
+
+		/* citro2d doesn't use a depth buffer, so don't create one. */
+		texture->target = C3D_RenderTargetCreateFromTex(&texture->tex, GPU_TEXFACE_2D, 0, -1);
+		if (!texture->target) {
+			C3D_TexDelete(&texture->tex);
+			return false;
 		}
+
+		/* Render targets are upside down in the texture. */
+		texture->subtex = { (u16)w, (u16)h, 0.0f, 1.0f, (float)w / texW, 1.0f - (float)h / texH };
+
+		widgetCache.push_front({ key, w, h, (size_t)texW * texH * 4, false, std::shared_ptr<WidgetTexture>(texture.release(), retireTexture) }); // RGBA8.
+		widgetCacheMap[key] = widgetCache.begin();
+		widgetCacheBytes += widgetCache.front().bytes;
+		trimWidgetCache();
+
+	} else {
+		widgetCache.splice(widgetCache.begin(), widgetCache, found->second); // Mark as most recently used.
 	}
+
+	CachedWidget &widget = widgetCache.front();
+	WidgetTexture *texture = widget.texture.get();
+
+	if (!widget.valid) {
+		beforeOtherDraw();
+
+		/* Neither record the offscreen draws into a display list nor draw them silently. */
+		DisplayList *recording = DisplayList::Suspend();
+		C3D_RenderTarget *previous = sceneTarget;
+		const float depth = drawDepth;
+
+		const bool clipped = clipping;
+		const Gui::Rect clip = clipRect;
+		if (clipped) applyClip(false, 0, 0, 0, 0);
+
+		C2D_TargetClear(texture->target, C2D_Color32(0, 0, 0, 0));
+		C2D_SceneBegin(texture->target);
+		sceneTarget = texture->target; // Clips of the widget itself don't apply to the texture.
+		draw();
+		beforeOtherDraw();
+
+		sceneTarget = previous;
+		if (previous) C2D_SceneBegin(previous);
+		if (clipped || clipping) applyClip(clipped, clip.x, clip.y, clip.w, clip.h);
+		DisplayList::Resume(recording);
+		drawDepth = depth;
+		widget.valid = true;
+	}
+
+#ifdef UC_DRAW_LOG
+	logDraw(Gui::DrawCommandType::Sprite, x, y, 1, 1, 0, texture->target);
+#endif
+
+	/* A display list replays the texture without calling this again, so it keeps the texture alive itself. */
+	if (DisplayList::Recording()) DisplayList::Recording()->Keep(widget.texture);
+
+	queueImage({ &texture->tex, &texture->subtex }, x, y, 1, 1, texture->target, 0);
+	return true;
+}
+
+/*
+	Let a cached widget get rendered again on its next draw.
+
+	const std::string &key: The name of the widget.
+*/
+void Gui::invalidateCached(const std::string &key) {
+	auto found = widgetCacheMap.find(key);
+	if (found != widgetCacheMap.end()) found->second->valid = false;
+}
+
+/*
+	Set the maximum texture memory of the cached widgets.
+
+	size_t bytes: The budget in bytes.
+*/
+void Gui::setWidgetCacheBudget(size_t bytes) {
+	widgetCacheBudget = bytes;
+	trimWidgetCache();
+}
+
+/*
+	Drop all cached widgets.
+*/
+void Gui::clearWidgetCache(void) {
+	while (!widgetCache.empty()) retireWidget(widgetCache.begin());
 }
 
 /*
@@ -88,7 +818,9 @@ Result Gui::init(CFG_Region fontRegion) {
 	Bottom = C2D_CreateScreenTarget(GFX_BOTTOM, GFX_LEFT);
 
 	/* Load Textbuffer. */
-	TextBuf = C2D_TextBufNew(4096);
+	TextBuf = C2D_TextBufNew(textBufSize);
+	MeasureBuf = C2D_TextBufNew(16);
+	LightLock_Init(&metricsLock);
 	loadSystemFont(fontRegion);
 	return 0;
 }
@@ -100,6 +832,7 @@ Result Gui::init(CFG_Region fontRegion) {
 */
 void Gui::loadSystemFont(CFG_Region fontRegion) {
 	if(loadedSystemFont != fontRegion) {
+		if (Font) Gui::invalidateTextCache(Font);
 		Font = C2D_FontLoadSystem(fontRegion);
 		loadedSystemFont = fontRegion;
 	}
@@ -112,7 +845,8 @@ void Gui::loadSystemFont(CFG_Region fontRegion) {
 	const char *Path: The path to the file.
 */
 Result Gui::loadFont(C2D_Font &fnt, const char *Path) {
-	if (access(Path, F_OK) == 0) fnt = C2D_FontLoad(Path); // Only load if found.
+	C2D_Font loaded = Gui::acquireFont(Path); // Shared with other users of the same file.
+	if (loaded) fnt = loaded; // Only set if found.
 
 	return 0;
 }
@@ -123,206 +857,659 @@ Result Gui::loadFont(C2D_Font &fnt, const char *Path) {
 	C2D_Font &fnt: The reference to the C2D_Font variable.
 */
 Result Gui::unloadFont(C2D_Font &fnt) {
-	if (fnt) C2D_FontFree(fnt); // Make sure to only unload if not nullptr.
+	if (fnt && !Gui::releaseFont(fnt)) { // Make sure to only unload if not nullptr. Registry Fonts get free'd by it.
+		Gui::invalidateTextCache(fnt); // Cached Texts would point to the free'd glyph sheets.
+		C2D_FontFree(fnt);
+	}
+
+	return 0;
+}
+
+/*
+	Load a t3x SpriteSheet.
+
+	const char *Path: The path to the file.
+	C2D_SpriteSheet &sheet: The reference to the C2D_SpriteSheet variable.
+*/
+Result Gui::loadSheet(const char *Path, C2D_SpriteSheet &sheet) {
+	C2D_SpriteSheet loaded = Gui::acquireSheet(Path); // Shared with other users of the same file.
+	if (loaded) sheet = loaded; // Only set if found.
+
+	return 0;
+}
+
+/*
+	Unload a SpriteSheet.
+
+	C2D_SpriteSheet &sheet: The reference to the C2D_SpriteSheet variable.
+*/
+Result Gui::unloadSheet(C2D_SpriteSheet &sheet) {
+	if (sheet && !Gui::releaseSheet(sheet)) C2D_SpriteSheetFree(sheet); // Make sure to only unload if not nullptr. Registry sheets get free'd by it.
+
+	return 0;
+}
+
+/*
+	Exit the GUI.
+
+	Contains deinitializing Citro2D, Citro3D and clearing the textbuffer.
+	Call this when exiting the app.
+*/
+void Gui::exit(void) {
+	Gui::setThreadedLogic(false);
+	finishScreenBuild();
+	tempScreen = nullptr;
+	if (usedScreen) usedScreen = nullptr;
+	while (!screens.empty()) screens.pop(); // Their display lists may still keep cached widgets.
+	Gui::clearScreenCache();
+	Gui::clearWidgetCache();
+	freeRetiredWidgets(retiredWidgets);
+	freeRetiredWidgets(retiredWidgetsOld);
+	Gui::stopAsyncLoader();
+	Gui::finishAssets();
+	Gui::setAssetBudget(0); // Free the unreferenced assets, acquired ones stay until they get released.
+	Gui::clearTextCache();
+	C2D_TextBufDelete(TextBuf);
+	C2D_TextBufDelete(MeasureBuf);
+	C2D_Fini();
+	C3D_Fini();
+}
+
+/*
+	Reinitialize the GUI.
+
+	fontRegion: The region to use for the system font.
+*/
+Result Gui::reinit(CFG_Region fontRegion) {
+	C2D_TextBufDelete(TextBuf);
+	C2D_TextBufDelete(MeasureBuf);
+	C2D_Fini();
+	C3D_Fini();
+
+	return Gui::init(fontRegion);
+}
+
+/*
+	Draw a Centered String.
+
+	float x: The X-Addition offset for the position from 200 (top) or 160 (bottom).
+	float y: The Y-Position where to draw.
+	float size: The size for the Font.
+	u32 color: The Text Color.
+	std::string Text: The Text which should be drawn.
+	int maxWidth: (Optional) The max width of the Text.
+	int maxHeight: (Optional) The max height of the Text.
+	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+	int flags: (Optional) C2D text flags to use.
+*/
+void Gui::DrawStringCentered(float x, float y, float size, u32 color, const std::string &Text, int maxWidth, int maxHeight, C2D_Font fnt, int flags) {
+	Gui::DrawString(x +(currentScreen ? 200 : 160), y, size, color, Text, maxWidth, maxHeight, fnt, flags | C2D_AlignCenter);
+}
+
+/*
+	Draw a String.
+
+	float x: The X-Position where to draw.
+	float y: The Y-Position where to draw.
+	float size: The size for the Font.
+	u32 color: The Text Color.
+	std::string Text: The Text which should be drawn.
+	int maxWidth: (Optional) The max width of the Text.
+	int maxHeight: (Optional) The max height of the Text.
+	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+	int flags: (Optional) C2D text flags to use.
+*/
+void Gui::DrawString(float x, float y, float size, u32 color, const std::string &Text, int maxWidth, int maxHeight, C2D_Font fnt, int flags) {
+	Gui::DrawStringMeasured(x, y, size, color, Text, nullptr, nullptr, maxWidth, maxHeight, fnt, flags);
+}
+
+/*
+	Draw a String and return the size it got drawn with.
+
+	The Text is only parsed once, the fit scale for maxWidth and maxHeight is calculated from that same parsed Text.
+
+	float x: The X-Position where to draw.
+	float y: The Y-Position where to draw.
+	float size: The size for the Font.
+	u32 color: The Text Color.
+	std::string Text: The Text which should be drawn.
+	float *width: Pointer where to store the drawn width. (Optional!)
+	float *height: Pointer where to store the drawn height. (Optional!)
+	int maxWidth: (Optional) The max width of the Text.
+	int maxHeight: (Optional) The max height of the Text.
+	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+	int flags: (Optional) C2D text flags to use.
+*/
+void Gui::DrawStringMeasured(float x, float y, float size, u32 color, const std::string &Text, float *width, float *height, int maxWidth, int maxHeight, C2D_Font fnt, int flags) {
+	UC_PROFILE(DrawString);
+
+	C2D_Text scratch;
+	std::shared_ptr<void> owner;
+	const C2D_Text *c2d_text = getText(scratch, Text, fnt ? fnt : Font, owner);
+
+	if(!fnt) {
+		switch(loadedSystemFont) {
+			case CFG_REGION_CHN:
+			case CFG_REGION_KOR:
+			case CFG_REGION_TWN:
+				y += 3.0f * size;
+				break;
+			default:
+				break;
+		}
+	}
+
+	if (!DisplayList::Silent()) drawCount++;
+
+	float textWidth = 0, textHeight = 0;
+	if (maxWidth != 0 || maxHeight != 0 || width || height || !spriteBatch.empty()) C2D_TextGetDimensions(c2d_text, size, size, &textWidth, &textHeight);
+
+	/* Wrapped and baseline Texts could cover more than measured, so those always submit the queued sprites. */
+	if (!spriteBatch.empty() && !(flags & (C2D_WordWrap | C2D_AtBaseline))) {
+		const float align = (flags & C2D_AlignMask) == C2D_AlignRight ? 1.0f : (flags & C2D_AlignMask) == C2D_AlignCenter ? 0.5f : 0.0f;
+		const float margin = 2.0f; // Glyphs may reach a little past their advance.
+		beforeOtherDraw(x - textWidth * align - margin, y - margin, x + textWidth * (1.0f - align) + margin, y + textHeight + margin);
+
+	} else {
+		beforeOtherDraw();
+	}
+
+	float widthScale = size, heightScale = size;
+	if (maxHeight != 0) heightScale = std::min(size, size*(maxHeight/textHeight));
+
+	if (maxWidth != 0 && (flags & C2D_WordWrap)) {
+		if (!DisplayList::Silent()) C2D_DrawText(c2d_text, C2D_WithColor | flags, x, y, 0.5f, size, heightScale, color, (float)maxWidth);
+		textWidth = std::min(textWidth, (float)maxWidth); // The height stays the one of the unwrapped Text.
+
+	} else {
+		if (maxWidth != 0) widthScale = std::min(size, size*(maxWidth/textWidth));
+		if (!DisplayList::Silent()) C2D_DrawText(c2d_text, C2D_WithColor | flags, x, y, 0.5f, widthScale, heightScale, color);
+	}
+
+	if (DisplayList::Recording()) {
+		const float wrapWidth = (maxWidth != 0 && (flags & C2D_WordWrap)) ? maxWidth : 0;
+		DisplayList::Recording()->AddText(Text, fnt ? fnt : Font, C2D_WithColor | flags, x, y, widthScale, heightScale, color, wrapWidth, drawDepth, owner ? c2d_text : nullptr, owner);
+	}
+
+#ifdef UC_DRAW_LOG
+	logDraw(Gui::DrawCommandType::Text, x, y, widthScale, heightScale, color, fnt ? fnt : Font, flags, Text);
+#endif
+
+	if (size != 0) {
+		if (width) *width = textWidth * (widthScale / size);
+		if (height) *height = textHeight * (heightScale / size);
+
+	} else {
+		if (width) *width = 0;
+		if (height) *height = 0;
+	}
+}
+
+/*
+	Get String or Text Width.
+
+	float size: The Textsize.
+	std::string Text: The Text.
+	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+*/
+float Gui::GetStringWidth(float size, const std::string &Text, C2D_Font fnt) {
+	float width = 0;
+
+	if (fnt) GetStringSize(size, &width, NULL, Text, fnt);
+	else GetStringSize(size, &width, NULL, Text);
+
+	return width;
+}
+
+/*
+	Get String or Text Size.
+
+	float size: The Textsize.
+	float *width: Pointer where to store the width.
+	float *height: Pointer where to store the height.
+	std::string Text: The Text.
+	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+*/
+void Gui::GetStringSize(float size, float *width, float *height, const std::string &Text, C2D_Font fnt) {
+	UC_PROFILE(GetStringSize);
+
+	LightLock_Lock(&metricsLock);
+	GlyphMetrics &metrics = getGlyphMetrics(fnt ? fnt : Font);
+	const u8 *p = (const u8 *)Text.c_str();
+	float lineWidth = 0, maxWidth = 0;
+	u32 lines = 1;
+
+	/* Same line handling as C2D_TextFontParse, without touching a Textbuffer. */
+	while (*p) {
+		u32 codepoint;
+		ssize_t units = decode_utf8(&codepoint, p);
+
+		if (units == -1) {
+			codepoint = 0xFFFD;
+			units = 1;
+		}
+
+		p += units;
+
+		if (codepoint == '\n') {
+			maxWidth = std::max(maxWidth, lineWidth);
+			lineWidth = 0;
+			lines++;
+
+		} else if (codepoint < 256) {
+			lineWidth += metrics.advance[codepoint];
+
+		} else {
+			auto found = metrics.extra.find(codepoint);
+			if (found == metrics.extra.end()) found = metrics.extra.emplace(codepoint, glyphAdvance(fnt ? fnt : Font, codepoint)).first;
+
+			lineWidth += found->second;
+		}
+	}
+
+	if (width) *width = size * std::max(maxWidth, lineWidth);
+	if (height) *height = ceilf(size * metrics.lineHeight) * lines;
+	LightLock_Unlock(&metricsLock);
+}
+
+/*
+	Get String or Text Height.
+
+	float size: The Textsize.
+	std::string Text: The Text.
+	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+*/
+float Gui::GetStringHeight(float size, const std::string &Text, C2D_Font fnt) {
+	float height = 0;
+
+	if (fnt) GetStringSize(size, NULL, &height, Text, fnt);
+	else GetStringSize(size, NULL, &height, Text);
+
+	return height;
+}
+
+/*
+	Draw a Rectangle.
+
+	float x: The X-Position where to draw.
+	float y: The Y-Position where to draw.
+	float w: The width of the rectangle.
+	float h: The height of the rectangle.
+	u32 color: The color.
+*/
+bool Gui::Draw_Rect(float x, float y, float w, float h, u32 color) {
+	UC_PROFILE(DrawRect);
+
+	beforeOtherDraw(std::min(x, x + w), std::min(y, y + h), std::max(x, x + w), std::max(y, y + h));
+
+	return emitRect(x, y, w, h, color);
+}
+
+/*
+	Draw multiple Rectangles in one pass.
+
+	const Gui::Rect *rects: The Rectangles.
+	size_t count: The amount of Rectangles.
+
+	Rectangles without size or fully transparent ones get skipped.
+*/
+bool Gui::Draw_Rects(const Gui::Rect *rects, size_t count) {
+	UC_PROFILE(DrawRect);
+
+	bool drawn = true;
+
+	if (!spriteBatch.empty() && count > 0) {
+		float left = rects[0].x, top = rects[0].y, right = left, bottom = top;
+
+		for (size_t i = 0; i < count; i++) {
+			const Gui::Rect &rect = rects[i];
+
+			left = std::min(left, std::min(rect.x, rect.x + rect.w));
+			top = std::min(top, std::min(rect.y, rect.y + rect.h));
+			right = std::max(right, std::max(rect.x, rect.x + rect.w));
+			bottom = std::max(bottom, std::max(rect.y, rect.y + rect.h));
+		}
+
+		beforeOtherDraw(left, top, right, bottom);
+
+	} else {
+		beforeOtherDraw();
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const Gui::Rect &rect = rects[i];
+
+		if (rect.w > 0 && rect.h > 0 && (rect.color >> 24) != 0) drawn &= emitRect(rect.x, rect.y, rect.w, rect.h, rect.color);
+	}
+
+	return drawn;
+}
+
+/*
+	Draw multiple outlined Rectangles in one pass.
+
+	const Gui::Outline *outlines: The outlined Rectangles.
+	size_t count: The amount of outlined Rectangles.
+
+	Fully transparent backgrounds and outlines get skipped.
+*/
+bool Gui::Draw_Outlines(const Gui::Outline *outlines, size_t count) {
+	UC_PROFILE(DrawRect);
+
+	bool drawn = true;
+
+	if (!spriteBatch.empty() && count > 0) {
+		float left = outlines[0].x, top = outlines[0].y, right = left, bottom = top;
+
+		for (size_t i = 0; i < count; i++) {
+			const Gui::Outline &o = outlines[i];
+
+			left = std::min(left, std::min(o.x, o.x + o.w));
+			top = std::min(top, std::min(o.y, o.y + o.h));
+			right = std::max(right, std::max(o.x, o.x + o.w));
+			bottom = std::max(bottom, std::max(o.y, o.y + o.h));
+		}
+
+		beforeOtherDraw(left, top, right, bottom);
+
+	} else {
+		beforeOtherDraw();
+	}
+
+	for (size_t i = 0; i < count; i++) {
+		const Gui::Outline &o = outlines[i];
+
+		if ((o.bgColor >> 24) != 0) drawn &= emitRect(o.x, o.y, o.w, o.h, o.bgColor);
+
+		if ((o.color >> 24) != 0 && o.border > 0) {
+			drawn &= emitRect(o.x, o.y, o.w, o.border, o.color); // Top.
+			drawn &= emitRect(o.x, o.y + o.border, o.border, o.h - 2 * o.border, o.color); // Left.
+			drawn &= emitRect(o.x + o.w - o.border, o.y + o.border, o.border, o.h - 2 * o.border, o.color); // Right.
+			drawn &= emitRect(o.x, o.y + o.h - o.border, o.w, o.border, o.color); // Bottom.
+		}
+	}
+
+	return drawn;
+}
+
+/*
+	Draw's the current screen's draw.
+
+	bool stack: If using the stack-screens or not.
+*/
+void Gui::DrawScreen(bool stack) {
+	UC_PROFILE(DrawScreen);
+
+	Screen *screen = getScreen(stack);
+	if (!screen) return;
+
+	/* In stereo mode, 'DisplayList::Record' and 'Replay' draw the Top screen for both eyes. */
+	const float parallax = stereoEnabled ? osGet3DSliderState() * stereoMaxParallax : 0;
+	DisplayList::SetParallax(parallax);
+
+	/* Apps only clear 'Top', the right eye would otherwise keep the old frames. */
+	if (parallax > 0) C2D_TargetClear(TopRight, stereoClearColor);
+
+	if (screen->Retained()) {
+		/* Fades usually get drawn by the screen itself, so don't freeze them into the list. */
+		if (fadein || fadeout || fadein2 || fadeout2) {
+			screen->Invalidate(""); // Only the whole screen list, the named parts stay and get replayed.
+
+			if (parallax > 0) stereoList.Record([screen]() { screen->Draw(); });
+			else screen->Draw();
+
+		} else {
+			screen->Retain("", [screen]() { screen->Draw(); });
+		}
+
+	} else if (parallax > 0) {
+		stereoList.Record([screen]() { screen->Draw(); }); // Recorded every frame, since the screen isn't retained.
+
+	} else {
+		screen->Draw();
+	}
 
-	return 0;
+	DisplayList::SetParallax(0);
 }
 
 /*
-	Load a t3x SpriteSheet.
+	Enable or disable the frame pacing.
 
-	const char *Path: The path to the file.
-	C2D_SpriteSheet &sheet: The reference to the C2D_SpriteSheet variable.
+	bool enable: If frames without changes should be skipped.
+	int idleInterval: Still render every Nth idle frame. 0 never renders idle frames.
+	int wakeFrames: The amount of frames, which get rendered at full rate after the last input.
 */
-Result Gui::loadSheet(const char *Path, C2D_SpriteSheet &sheet) {
-	if (access(Path, F_OK) == 0) sheet = C2D_SpriteSheetLoad(Path); // Only load if found.
-
-	return 0;
+void Gui::setFramePacing(bool enable, int idleInterval, int wakeFrames) {
+	pacingEnabled = enable;
+	pacingIdleInterval = idleInterval;
+	pacingWakeFrames = wakeFrames;
+	framesSinceInput = idleFrames = 0;
+	redrawRequested = true;
 }
 
 /*
-	Unload a SpriteSheet.
+	Return if the current frame has to be rendered.
 
-	C2D_SpriteSheet &sheet: The reference to the C2D_SpriteSheet variable.
+	u32 hDown: The hidKeysDown() variable.
+	u32 hHeld: The hidKeysHeld() variable.
+	bool stack: If using the stack-screens or not.
 */
-Result Gui::unloadSheet(C2D_SpriteSheet &sheet) {
-	if (sheet) C2D_SpriteSheetFree(sheet); // Make sure to only unload if not nullptr.
+bool Gui::frameNeedsRender(u32 hDown, u32 hHeld, bool stack) {
+	if (!pacingEnabled) return true;
 
-	return 0;
-}
+	if (hDown || hHeld) framesSinceInput = 0; // Includes KEY_TOUCH.
+	else if (framesSinceInput < pacingWakeFrames) framesSinceInput++;
 
-/*
-	Exit the GUI.
+	const Screen *screen = getScreen(stack);
+	const bool active = redrawRequested || framesSinceInput < pacingWakeFrames || tempScreen || screenBuilder
+		|| fadein || fadeout || fadein2 || fadeout2 || Animation::anyRunning() || (screen && screen->Animating());
 
-	Contains deinitializing Citro2D, Citro3D and clearing the textbuffer.
-	Call this when exiting the app.
-*/
-void Gui::exit(void) {
-	C2D_TextBufDelete(TextBuf);
-	C2D_Fini();
-	C3D_Fini();
-	if (usedScreen) usedScreen = nullptr;
-}
+	redrawRequested = false;
 
-/*
-	Reinitialize the GUI.
+	if (active) {
+		idleFrames = 0;
+		return true;
+	}
 
-	fontRegion: The region to use for the system font.
-*/
-Result Gui::reinit(CFG_Region fontRegion) {
-	C2D_TextBufDelete(TextBuf);
-	C2D_Fini();
-	C3D_Fini();
+	if (pacingIdleInterval > 0 && ++idleFrames >= pacingIdleInterval) {
+		idleFrames = 0;
+		return true;
+	}
 
-	return Gui::init(fontRegion);
+	return false;
 }
 
 /*
-	Draw a Centered String.
-
-	float x: The X-Addition offset for the position from 200 (top) or 160 (bottom).
-	float y: The Y-Position where to draw.
-	float size: The size for the Font.
-	u32 color: The Text Color.
-	std::string Text: The Text which should be drawn.
-	int maxWidth: (Optional) The max width of the Text.
-	int maxHeight: (Optional) The max height of the Text.
-	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
-	int flags: (Optional) C2D text flags to use.
+	Let the next frame get rendered, even if nothing changed.
 */
-void Gui::DrawStringCentered(float x, float y, float size, u32 color, const std::string &Text, int maxWidth, int maxHeight, C2D_Font fnt, int flags) {
-	Gui::DrawString(x +(currentScreen ? 200 : 160), y, size, color, Text, maxWidth, maxHeight, fnt, flags | C2D_AlignCenter);
-}
+void Gui::requestRedraw(void) { redrawRequested = true; };
 
 /*
-	Draw a String.
+	Input events.
 
-	float x: The X-Position where to draw.
-	float y: The Y-Position where to draw.
-	float size: The size for the Font.
-	u32 color: The Text Color.
-	std::string Text: The Text which should be drawn.
-	int maxWidth: (Optional) The max width of the Text.
-	int maxHeight: (Optional) The max height of the Text.
-	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
-	int flags: (Optional) C2D text flags to use.
+	'Gui::ScreenLogic' turns the changes since the last frame into events and queues them after
+	the ones pushed through 'Gui::pushInputEvent', then hands them to event driven screens.
 */
-void Gui::DrawString(float x, float y, float size, u32 color, const std::string &Text, int maxWidth, int maxHeight, C2D_Font fnt, int flags) {
-	C2D_Text c2d_text;
+static std::vector<InputEvent> inputEvents;
+static u32 lastHeld = 0;
+static touchPosition lastTouch = { 0, 0 };
 
-	if (fnt) C2D_TextFontParse(&c2d_text, fnt, TextBuf, Text.c_str());
-	else C2D_TextFontParse(&c2d_text, Font, TextBuf, Text.c_str());
-
-	C2D_TextOptimize(&c2d_text);
+/*
+	Queue an input event. Consecutive TouchMove events get merged into one.
 
-	if(!fnt) {
-		switch(loadedSystemFont) {
-			case CFG_REGION_CHN:
-			case CFG_REGION_KOR:
-			case CFG_REGION_TWN:
-				y += 3.0f * size;
-				break;
-			default:
-				break;
-		}
+	const InputEvent &event: The event.
+*/
+void Gui::pushInputEvent(const InputEvent &event) {
+	if (event.type == InputEvent::Type::TouchMove && !inputEvents.empty() && inputEvents.back().type == InputEvent::Type::TouchMove) {
+		InputEvent &last = inputEvents.back();
+		last.touch = event.touch;
+		last.samples += event.samples;
+		return;
 	}
 
-	float heightScale;
+	inputEvents.push_back(event);
+}
 
-	if (maxHeight == 0) {
-		heightScale = size;
+static void queueInputEvents(u32 hDown, u32 hRepeat, u32 hHeld, touchPosition touch) {
+	const u64 now = svcGetSystemTick();
+	const u32 keys = ~KEY_TOUCH, hUp = lastHeld & ~hHeld;
 
-	} else {
-		if (fnt) heightScale = std::min(size, size*(maxHeight/Gui::GetStringHeight(size, Text, fnt)));
-		else heightScale = std::min(size, size*(maxHeight/Gui::GetStringHeight(size, Text)));
-	}
+	/* Touch first, so it can merge with TouchMove events pushed from outside. */
+	if (hDown & KEY_TOUCH) {
+		Gui::pushInputEvent({ InputEvent::Type::TouchDown, KEY_TOUCH, touch, touch, 1, now });
 
-	if (maxWidth == 0) {
-		C2D_DrawText(&c2d_text, C2D_WithColor | flags, x, y, 0.5f, size, heightScale, color);
-	} else if (flags & C2D_WordWrap) {
-		C2D_DrawText(&c2d_text, C2D_WithColor | flags, x, y, 0.5f, size, heightScale, color, (float)maxWidth);
-	} else {
-		if (fnt) C2D_DrawText(&c2d_text, C2D_WithColor | flags, x, y, 0.5f, std::min(size, size*(maxWidth/Gui::GetStringWidth(size, Text, fnt))), heightScale, color);
-		else C2D_DrawText(&c2d_text, C2D_WithColor | flags, x, y, 0.5f, std::min(size, size*(maxWidth/Gui::GetStringWidth(size, Text))), heightScale, color);
+	} else if (hHeld & KEY_TOUCH) {
+		if (touch.px != lastTouch.px || touch.py != lastTouch.py) Gui::pushInputEvent({ InputEvent::Type::TouchMove, KEY_TOUCH, touch, lastTouch, 1, now });
+
+	} else if (hUp & KEY_TOUCH) {
+		Gui::pushInputEvent({ InputEvent::Type::TouchUp, KEY_TOUCH, lastTouch, lastTouch, 1, now }); // The touch position is 0 after release.
 	}
+
+	if (hDown & keys) Gui::pushInputEvent({ InputEvent::Type::KeyDown, hDown & keys, touch, touch, 1, now });
+	if (hRepeat & keys) Gui::pushInputEvent({ InputEvent::Type::KeyRepeat, hRepeat & keys, touch, touch, 1, now });
+	if (hUp & keys) Gui::pushInputEvent({ InputEvent::Type::KeyUp, hUp & keys, touch, touch, 1, now });
+
+	lastHeld = hHeld;
+	if (hHeld & KEY_TOUCH) lastTouch = touch;
 }
 
 /*
-	Get String or Text Width.
+	Hand the queued events to an event driven screen.
+	Stops, once an event switched away from the screen.
 
-	float size: The Textsize.
-	std::string Text: The Text.
-	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+	Screen *screen: The screen.
+	bool stack: If using the stack-screens or not.
 */
-float Gui::GetStringWidth(float size, const std::string &Text, C2D_Font fnt) {
-	float width = 0;
-
-	if (fnt) GetStringSize(size, &width, NULL, Text, fnt);
-	else GetStringSize(size, &width, NULL, Text);
-
-	return width;
+static void dispatchInputEvents(Screen *screen, bool stack) {
+	for (size_t i = 0; i < inputEvents.size(); i++) {
+		screen->OnEvent(inputEvents[i]);
+		if (getScreen(stack) != screen) break;
+	}
 }
 
 /*
-	Get String or Text Size.
+	Threaded logic.
 
-	float size: The Textsize.
-	float *width: Pointer where to store the width.
-	float *height: Pointer where to store the height.
-	std::string Text: The Text.
-	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+	The logic thread runs one job at a time. The main thread only touches the job while the thread waits,
+	so handing it over needs no lock, only the two events.
 */
-void Gui::GetStringSize(float size, float *width, float *height, const std::string &Text, C2D_Font fnt) {
-	C2D_Text c2d_text;
+struct LogicJob {
+	Screen *screen;
+	u32 hDown, hDownRepeat, hHeld;
+	touchPosition touch;
+	std::vector<InputEvent> events;
+	bool eventDriven;
+};
+
+static Thread logicThread = nullptr;
+static LightEvent logicStart, logicDone;
+static LogicJob logicJob;
+static bool logicBusy = false, stopLogicThread = false;
+
+static void logicMain(void *) {
+	while (true) {
+		LightEvent_Wait(&logicStart);
+		if (stopLogicThread) break;
+
+		LogicJob &job = logicJob;
+		if (job.eventDriven) {
+			for (const InputEvent &event : job.events) job.screen->OnEvent(event);
 
-	if (fnt) C2D_TextFontParse(&c2d_text, fnt, TextBuf, Text.c_str());
-	else C2D_TextFontParse(&c2d_text, Font, TextBuf, Text.c_str());
+		} else {
+#ifdef UC_KEY_REPEAT
+			job.screen->Logic(job.hDown, job.hDownRepeat, job.hHeld, job.touch);
+#else
+			job.screen->Logic(job.hDown, job.hHeld, job.touch);
+#endif
+		}
 
-	C2D_TextGetDimensions(&c2d_text, size, size, width, height);
+		LightEvent_Signal(&logicDone);
+	}
 }
 
+static bool onLogicThread(void) {
+	return logicThread && threadGetCurrent() == logicThread;
+}
 
 /*
-	Get String or Text Height.
+	Hand the Logic of a threaded screen to the logic thread.
 
-	float size: The Textsize.
-	std::string Text: The Text.
-	C2D_Font fnt: (Optional) The wanted C2D_Font. Is nullptr by default.
+	Screen *screen: The screen.
+	u32 hDown, hDownRepeat, hHeld, touchPosition touch: The input of the frame.
+
+	Returns false, if threaded logic is off. The Logic then has to run right away.
 */
-float Gui::GetStringHeight(float size, const std::string &Text, C2D_Font fnt) {
-	float height = 0;
+static bool startLogic(Screen *screen, u32 hDown, u32 hDownRepeat, u32 hHeld, touchPosition touch) {
+	if (!logicThread) return false;
+
+	logicJob.screen = screen;
+	logicJob.hDown = hDown;
+	logicJob.hDownRepeat = hDownRepeat;
+	logicJob.hHeld = hHeld;
+	logicJob.touch = touch;
+	logicJob.eventDriven = screen->EventDriven();
+	logicJob.events = inputEvents;
+
+	logicBusy = true;
+	LightEvent_Signal(&logicStart);
+	return true;
+}
 
-	if (fnt) GetStringSize(size, NULL, &height, Text, fnt);
-	else GetStringSize(size, NULL, &height, Text);
+/*
+	Wait for the running Logic and let the screen publish its state.
+	The screen switches it asked for stay queued, for the screen switch which is going on right now.
+*/
+static void waitLogic(void) {
+	if (!logicBusy) return;
 
-	return height;
+	waitOnMain(&logicDone);
+	logicBusy = false;
+	logicJob.screen->Publish();
 }
 
 /*
-	Draw a Rectangle.
-
-	float x: The X-Position where to draw.
-	float y: The Y-Position where to draw.
-	float w: The width of the rectangle.
-	float h: The height of the rectangle.
-	u32 color: The color.
+	Wait for the running Logic, let the screen publish its state and do the screen switches it asked for.
 */
-bool Gui::Draw_Rect(float x, float y, float w, float h, u32 color) {
-	return C2D_DrawRectSolid(x, y, 0.5f, w, h, color);
+static void finishLogic(void) {
+	waitLogic();
+
+	std::vector<std::function<void()>> actions;
+	actions.swap(deferredActions);
+	for (const std::function<void()> &action : actions) action();
 }
 
 /*
-	Draw's the current screen's draw.
+	Turn the threaded logic on or off.
 
-	bool stack: If using the stack-screens or not.
+	bool enable: If the logic of threaded screens should run on its own thread.
+	int core: The CPU core of the logic thread.
 */
-void Gui::DrawScreen(bool stack) {
-	if (!stack) {
-		if (usedScreen) usedScreen->Draw();
-
-	} else {
-		if (!screens.empty()) screens.top()->Draw();
+bool Gui::setThreadedLogic(bool enable, int core) {
+	if (!enable) {
+		if (!logicThread) return true;
+
+		finishLogic();
+		stopLogicThread = true;
+		LightEvent_Signal(&logicStart);
+		threadJoin(logicThread, U64_MAX);
+		threadFree(logicThread);
+		logicThread = nullptr;
+		return true;
 	}
+
+	if (logicThread) return true;
+
+	s32 priority = 0x30;
+	svcGetThreadPriority(&priority, CUR_THREAD_HANDLE);
+
+	LightEvent_Init(&logicStart, RESET_ONESHOT);
+	LightEvent_Init(&logicDone, RESET_ONESHOT);
+	stopLogicThread = false;
+
+	logicThread = threadCreate(logicMain, nullptr, 0x10000, priority, core, false);
+	if (!logicThread && core != -2) logicThread = threadCreate(logicMain, nullptr, 0x10000, priority + 1, -2, false); // The core is not available.
+
+	return logicThread != nullptr;
 }
 
 /*
@@ -337,54 +1524,130 @@ void Gui::DrawScreen(bool stack) {
 */
 #ifdef UC_KEY_REPEAT
 void Gui::ScreenLogic(u32 hDown, u32 hDownRepeat, u32 hHeld, touchPosition touch, bool waitFade, bool stack) {
-	if (waitFade) {
-		if (!fadein && !fadeout && !fadein2 && !fadeout2) {
-			if (!stack) {
-				if (usedScreen)	usedScreen->Logic(hDown, hDownRepeat, hHeld, touch);
-
-			} else {
-				if (!screens.empty()) screens.top()->Logic(hDown, hDownRepeat, hHeld, touch);
-			}
-		}
+	UC_PROFILE(ScreenLogic);
 
-	} else {
-		if (!stack) {
-			if (usedScreen)	usedScreen->Logic(hDown, hDownRepeat, hHeld, touch);
+#ifdef UC_INPUT_RECORD
+	InputRecord::addFrame(hDown, hDownRepeat, hHeld, touch);
+#endif
 
-		} else {
-			if (!screens.empty()) screens.top()->Logic(hDown, hDownRepeat, hHeld, touch);
+	queueInputEvents(hDown, hDownRepeat & ~hDown, hHeld, touch);
+	finishLogic(); // The previous threaded Logic has to be done, before the screen may change.
+	Screen *screen = getScreen(stack);
+
+	if (screen && (!waitFade || (!fadein && !fadeout && !fadein2 && !fadeout2))) {
+		if (!screen->Threaded() || !startLogic(screen, hDown, hDownRepeat, hHeld, touch)) {
+			if (screen->EventDriven()) dispatchInputEvents(screen, stack);
+			else screen->Logic(hDown, hDownRepeat, hHeld, touch);
 		}
 	}
+
+	inputEvents.clear();
 }
 #else
 void Gui::ScreenLogic(u32 hDown, u32 hHeld, touchPosition touch, bool waitFade, bool stack) {
-	if (waitFade) {
-		if (!fadein && !fadeout && !fadein2 && !fadeout2) {
-			if (!stack) {
-				if (usedScreen)	usedScreen->Logic(hDown, hHeld, touch);
-
-			} else {
-				if (!screens.empty()) screens.top()->Logic(hDown, hHeld, touch);
-			}
-		}
+	UC_PROFILE(ScreenLogic);
 
-	} else {
-		if (!stack) {
-			if (usedScreen)	usedScreen->Logic(hDown, hHeld, touch);
+#ifdef UC_INPUT_RECORD
+	InputRecord::addFrame(hDown, 0, hHeld, touch);
+#endif
 
-		} else {
-			if (!screens.empty()) screens.top()->Logic(hDown, hHeld, touch);
+	queueInputEvents(hDown, 0, hHeld, touch);
+	finishLogic(); // The previous threaded Logic has to be done, before the screen may change.
+	Screen *screen = getScreen(stack);
+
+	if (screen && (!waitFade || (!fadein && !fadeout && !fadein2 && !fadeout2))) {
+		if (!screen->Threaded() || !startLogic(screen, hDown, 0, hHeld, touch)) {
+			if (screen->EventDriven()) dispatchInputEvents(screen, stack);
+			else screen->Logic(hDown, hHeld, touch);
 		}
 	}
+
+	inputEvents.clear();
 }
 #endif
 
+static void screenBuilderMain(void *) {
+	builtScreen = screenFactory();
+	LightEvent_Signal(&screenBuilt);
+}
+
+/*
+	Wait for the deferred screen construction, if any, and make the result the tempScreen.
+	Returns right away, if it already finished during the fade.
+*/
+static void finishScreenBuild(void) {
+	if (!screenBuilder) return;
+
+	waitOnMain(&screenBuilt);
+	threadJoin(screenBuilder, U64_MAX);
+	threadFree(screenBuilder);
+	screenBuilder = nullptr;
+	screenFactory = nullptr;
+
+	tempScreen = std::move(builtScreen);
+}
+
+/*
+	Screen cache.
+
+	Popped stack screens with a 'Screen::CacheId' get suspended and kept here, the front is the most recently popped one.
+*/
+struct CachedScreen {
+	std::type_index type;
+	int id;
+	size_t bytes;
+	std::unique_ptr<Screen> screen;
+};
+
+static std::list<CachedScreen> screenCache;
+static size_t screenCacheBudget = 0, screenCacheBytes = 0;
+
+static void trimScreenCache(void) {
+	while (!screenCache.empty() && (screenCacheBytes > screenCacheBudget || screenCacheBudget == 0)) {
+		screenCacheBytes -= screenCache.back().bytes;
+		screenCache.pop_back();
+	}
+}
+
+/*
+	Pop the top of the screen stack and either keep it in the screen cache or destroy it.
+*/
+static void popScreen(void) {
+	waitLogic(); // The screen may still run its Logic. Its screen switches run with the next 'ScreenLogic'.
+	std::unique_ptr<Screen> screen = std::move(screens.top());
+	screens.pop();
+
+	const int id = screen->CacheId();
+	if (screenCacheBudget == 0 || id < 0) return;
+
+	const std::type_index type = typeid(*screen);
+	for (auto it = screenCache.begin(); it != screenCache.end(); ++it) {
+		if (it->type == type && it->id == id) { // The newer instance replaces the old one.
+			screenCacheBytes -= it->bytes;
+			screenCache.erase(it);
+			break;
+		}
+	}
+
+	screen->OnSuspend();
+	screen->Invalidate(); // The recorded sprites may point into sheets 'OnSuspend' just free'd.
+	const size_t bytes = screen->CacheBytes();
+
+	screenCache.push_front({ type, id, bytes, std::move(screen) });
+	screenCacheBytes += bytes;
+	trimScreenCache();
+}
+
 /*
 	Move's the tempScreen to the used one.
 
 	bool stack: If using the stack-screens or not.
 */
 void Gui::transferScreen(bool stack) {
+	waitLogic(); // The replaced screen may still run its Logic. Its screen switches run with the next 'ScreenLogic'.
+	finishScreenBuild();
+	redrawRequested = true;
+
 	if (!stack) {
 		if (tempScreen) usedScreen = std::move(tempScreen);
 
@@ -401,6 +1664,13 @@ void Gui::transferScreen(bool stack) {
 	bool stack: If using the stack-screens or not.
 */
 void Gui::setScreen(std::unique_ptr<Screen> screen, bool fade, bool stack) {
+	if (onLogicThread()) {
+		Screen *raw = screen.release();
+		deferredActions.push_back([raw, fade, stack]() { Gui::setScreen(std::unique_ptr<Screen>(raw), fade, stack); });
+		return;
+	}
+
+	finishScreenBuild(); // A still running deferred screen gets replaced.
 	tempScreen = std::move(screen);
 
 	/* Switch screen without fade. */
@@ -413,6 +1683,43 @@ void Gui::setScreen(std::unique_ptr<Screen> screen, bool fade, bool stack) {
 	}
 }
 
+/*
+	Set the current Screen, constructing it on a worker thread while the fadeout plays.
+
+	std::function<std::unique_ptr<Screen>()> factory: The function which constructs the screen.
+	bool fade: If doing a fade effect or not. Without it, the screen gets constructed right away.
+	bool stack: If using the stack-screens or not.
+*/
+void Gui::setScreenDeferred(std::function<std::unique_ptr<Screen>()> factory, bool fade, bool stack) {
+	if (onLogicThread()) {
+		deferredActions.push_back([factory, fade, stack]() { Gui::setScreenDeferred(factory, fade, stack); });
+		return;
+	}
+
+	finishScreenBuild(); // Only one construction at a time.
+
+	if (fade) {
+		s32 priority = 0x30;
+		svcGetThreadPriority(&priority, CUR_THREAD_HANDLE);
+
+		screenFactory = std::move(factory);
+		LightEvent_Init(&screenBuilt, RESET_ONESHOT);
+		/* Lower priority than the main thread, so the fade keeps running smoothly. */
+		screenBuilder = threadCreate(screenBuilderMain, nullptr, 0x10000, priority + 1, -2, false);
+
+		if (screenBuilder) {
+			tempScreen = nullptr; // Replaced by the built screen in 'Gui::transferScreen'.
+			fadeout = true;
+			return;
+		}
+
+		factory = std::move(screenFactory);
+		screenFactory = nullptr;
+	}
+
+	Gui::setScreen(factory(), fade, stack);
+}
+
 /*
 	Fade's the screen in and out and transfer the screen.
 	Credits goes to RocketRobz & SavvyManager.
@@ -422,51 +1729,52 @@ void Gui::setScreen(std::unique_ptr<Screen> screen, bool fade, bool stack) {
 	bool stack: If using the stack-screens or not. (Used to properly transfer screens).
 */
 void Gui::fadeEffects(int fadeoutFrames, int fadeinFrames, bool stack) {
-	if (fadein) {
-		fadealpha -= fadeinFrames;
+	UC_PROFILE(FadeEffects);
 
-		if (fadealpha < 0) {
-			fadealpha = 0;
-			fadecolor = 255;
-			fadein = false;
-		}
-	}
+	Animation::update();
 
-	if (stack) {
-		if (fadein2) {
-			fadealpha -= fadeinFrames;
+	const bool wantsFadeout = fadeout || (stack && fadeout2);
 
-			if (fadealpha < 0) {
-				fadealpha = 0;
-				fadecolor = 255;
-				fadein2 = false;
-			}
-		}
-	}
+	/* A new fadeout takes over a running fadein. */
+	if (fadeDirection == 1 && wantsFadeout) Animation::stop(fadeAnimation);
 
-	if (fadeout) {
-		fadealpha += fadeoutFrames;
+	if (!Animation::running(fadeAnimation)) {
+		/* The frame values are alpha steps per frame at 60 FPS, so turn them into durations. */
+		const float outDuration = (255 - fadealpha) / (std::max(fadeoutFrames, 1) * 60.0f);
+		const float inDuration = fadealpha / (std::max(fadeinFrames, 1) * 60.0f);
+
+		if (wantsFadeout) {
+			fadeDirection = 0;
+			fadeAnimation = Animation::start(fadealpha, 255, outDuration, Animation::Ease::Linear, [stack]() {
+				fadealpha = 255;
 
-		if (fadealpha > 255) {
-			fadealpha = 255;
-			Gui::transferScreen(stack); // Transfer Temp screen to the stack / used one.
-			fadein = true;
-			fadeout = false;
+				if (fadeout) {
+					Gui::transferScreen(stack); // Transfer Temp screen to the stack / used one.
+					fadein = true;
+					fadeout = false;
+
+				} else {
+					Gui::screenBack2(); // Go screen back.
+					fadein2 = true;
+					fadeout2 = false;
+				}
+			});
+
+		} else if (fadein || (stack && fadein2)) {
+			fadeDirection = 1;
+			fadeAnimation = Animation::start(fadealpha, 0, inDuration, Animation::Ease::Linear, []() {
+				fadealpha = 0;
+				fadecolor = 255;
+				fadein = fadein2 = false;
+			});
 		}
 	}
 
-	if (stack) {
-		if (fadeout2) {
-			fadealpha += fadeoutFrames;
+	if (Animation::running(fadeAnimation)) fadealpha = Animation::value(fadeAnimation);
 
-			if (fadealpha > 255) {
-				fadealpha = 255;
-				Gui::screenBack2(); // Go screen back.
-				fadein2 = true;
-				fadeout2 = false;
-			}
-		}
-	}
+#ifdef UC_DRAW_LOG
+	if (fadealpha > 0) logDraw(Gui::DrawCommandType::Fade, 0, 0, 0, 0, C2D_Color32(fadecolor, fadecolor, fadecolor, fadealpha));
+#endif
 }
 
 /*
@@ -475,14 +1783,87 @@ void Gui::fadeEffects(int fadeoutFrames, int fadeinFrames, bool stack) {
 	bool fade: If doing a fade or not.
 */
 void Gui::screenBack(bool fade) {
+	if (onLogicThread()) {
+		deferredActions.push_back([fade]() { Gui::screenBack(fade); });
+		return;
+	}
+
+	redrawRequested = true;
+
 	if (!fade) {
-		if (screens.size() > 0) screens.pop();
+		if (screens.size() > 0) popScreen();
 
 	} else {
 		if (screens.size() > 0) fadeout2 = true;
 	}
 }
-void Gui::screenBack2() { if (screens.size() > 0) screens.pop(); };
+void Gui::screenBack2() {
+	redrawRequested = true;
+	if (screens.size() > 0) popScreen();
+};
+
+/*
+	Set the memory budget of the screen cache.
+
+	size_t bytes: The maximum of the summed up 'Screen::CacheBytes'. 0 disables the cache.
+*/
+void Gui::setScreenCacheBudget(size_t bytes) {
+	screenCacheBudget = bytes;
+	trimScreenCache();
+}
+
+/*
+	Destroy all screens in the screen cache.
+*/
+void Gui::clearScreenCache(void) {
+	screenCache.clear();
+	screenCacheBytes = 0;
+}
+
+/*
+	Take a screen out of the screen cache and resume it.
+
+	std::type_index type: The type of the screen class.
+	int id: The 'Screen::CacheId' of the screen.
+*/
+std::unique_ptr<Screen> Gui::takeCachedScreen(std::type_index type, int id) {
+	for (auto it = screenCache.begin(); it != screenCache.end(); ++it) {
+		if (it->type == type && it->id == id) {
+			std::unique_ptr<Screen> screen = std::move(it->screen);
+			screenCacheBytes -= it->bytes;
+			screenCache.erase(it);
+
+			screen->OnResume();
+			return screen;
+		}
+	}
+
+	return nullptr;
+}
+
+/*
+	Turn the stereoscopic 3D mode on or off.
+
+	bool enable: If the 3D mode should be used.
+	float maxParallax: The offset in pixels for each eye of a draw with a depth of 1, with the 3D slider at the top.
+	u32 clearColor: The color 'TopRight' gets cleared with, before it gets drawn.
+*/
+void Gui::setStereo(bool enable, float maxParallax, u32 clearColor) {
+	stereoEnabled = enable;
+	stereoMaxParallax = maxParallax;
+	stereoClearColor = clearColor;
+	gfxSet3D(enable);
+
+	if (!enable) stereoList.Clear();
+	redrawRequested = true;
+}
+
+/*
+	Set the stereoscopic depth of the following draws, until the next 'Gui::ScreenDraw'.
+
+	float depth: The depth. Positive comes out of the screen, negative goes into it.
+*/
+void Gui::setDepth(float depth) { drawDepth = depth; };
 
 /*
 	Select, on which Screen should be drawn.
@@ -490,10 +1871,49 @@ void Gui::screenBack2() { if (screens.size() > 0) screens.pop(); };
 	C3D_RenderTarget *screen: The render target.
 */
 void Gui::ScreenDraw(C3D_RenderTarget *screen) {
-	C2D_SceneBegin(screen);
+	beforeOtherDraw();
+	if (!DisplayList::Silent()) C2D_SceneBegin(screen);
+	sceneTarget = screen;
+	if (DisplayList::Recording()) DisplayList::Recording()->AddScene(screen);
+	drawDepth = 0;
+
+#ifdef UC_DRAW_LOG
+	logDraw(Gui::DrawCommandType::SceneBegin, 0, 0, 0, 0, 0, screen);
+#endif
 	currentScreen = (screen == Top || screen == TopRight) ? 1 : 0;
 }
 
+/*
+	Only draw inside of a Rectangle of the current screen, until 'Gui::ResetClip'.
+
+	float x: The X-Position of the Rectangle.
+	float y: The Y-Position of the Rectangle.
+	float w: The width of the Rectangle.
+	float h: The height of the Rectangle.
+*/
+void Gui::SetClip(float x, float y, float w, float h) {
+	beforeOtherDraw(); // Queued sprites don't get clipped.
+	if (!DisplayList::Silent()) applyClip(true, x, y, w, h);
+	if (DisplayList::Recording()) DisplayList::Recording()->AddClip(true, x, y, w, h, drawDepth);
+
+#ifdef UC_DRAW_LOG
+	logDraw(Gui::DrawCommandType::Clip, x, y, w, h, 0, nullptr, 1);
+#endif
+}
+
+/*
+	Draw on the whole screen again.
+*/
+void Gui::ResetClip(void) {
+	beforeOtherDraw(); // Queued sprites still get clipped.
+	if (!DisplayList::Silent()) applyClip(false, 0, 0, 0, 0);
+	if (DisplayList::Recording()) DisplayList::Recording()->AddClip(false, 0, 0, 0, 0, drawDepth);
+
+#ifdef UC_DRAW_LOG
+	logDraw(Gui::DrawCommandType::Clip, 0, 0, 0, 0, 0, nullptr, 0);
+#endif
+}
+
 /*
 	Draw a grid.
 
@@ -505,19 +1925,9 @@ void Gui::ScreenDraw(C3D_RenderTarget *screen) {
 	u32 bgColor: The BG Color of the grid.
 */
 void Gui::drawGrid(float xPos, float yPos, float Width, float Height, u32 color, u32 bgColor) {
-	static constexpr int w	= 1;
-
-	/* BG Color for the Grid. (Transparent by default.) */
-	Gui::Draw_Rect(xPos, yPos, Width, Height, bgColor);
+	const Gui::Outline grid = { xPos, yPos, Width, Height, color, bgColor, 1 };
 
-	/* Grid part, Top. */
-	Gui::Draw_Rect(xPos, yPos, Width, w, color);
-	/* Left. */
-	Gui::Draw_Rect(xPos, yPos + w, w, Height - 2 * w, color);
-	/* Right. */
-	Gui::Draw_Rect(xPos + Width - w, yPos + w, w, Height - 2 * w, color);
-	/* Bottom. */
-	Gui::Draw_Rect(xPos, yPos + Height - w, Width, w, color);
+	Gui::Draw_Outlines(&grid, 1);
 }
 
 /*
@@ -532,25 +1942,13 @@ void Gui::drawGrid(float xPos, float yPos, float Width, float Height, u32 color,
 	u32 bgColor: The selector BG color.
 */
 void Gui::drawAnimatedSelector(float xPos, float yPos, float Width, float Height, float speed, u32 SelectorColor, u32 bgColor) {
-	static constexpr int w		= 2;
-	static float timer			= 0.0f;
+	const float timer			= Animation::time() * speed * 60.0f; // speed is per frame at 60 FPS.
 	float highlight_multiplier  = fmax(0.0, fabs(fmod(timer, 1.0) - 0.5) / 0.5);
 	u8 r						= SelectorColor & 0xFF;
 	u8 g						= (SelectorColor >> 8) & 0xFF;
 	u8 b						= (SelectorColor >> 16) & 0xFF;
 	u32 color 					= C2D_Color32(r + (255 - r) * highlight_multiplier, g + (255 - g) * highlight_multiplier, b + (255 - b) * highlight_multiplier, 255);
 
-	/* BG Color for the Selector. */
-	Gui::Draw_Rect(xPos, yPos, Width, Height, bgColor);
-
-	/* Selector part, Top. */
-	Gui::Draw_Rect(xPos, yPos, Width, w, color);
-	/* Left. */
-	Gui::Draw_Rect(xPos, yPos + w, w, Height - 2 * w, color);
-	/* Right. */
-	Gui::Draw_Rect(xPos + Width - w, yPos + w, w, Height - 2 * w, color);
-	/* Bottom. */
-	Gui::Draw_Rect(xPos, yPos + Height - w, Width, w, color);
-
-	timer += speed;
+	const Gui::Outline selector = { xPos, yPos, Width, Height, color, bgColor, 2 };
+	Gui::Draw_Outlines(&selector, 1);
 }
\ No newline at end of file
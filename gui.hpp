@@ -32,6 +32,14 @@
 #include <3ds.h>
 #include <citro2d.h>
 #include <citro3d.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <typeindex>
+
+#ifdef UC_DRAW_LOG
+	#include <vector>
+#endif
 
 namespace Gui {
 	/*
@@ -39,6 +47,112 @@ namespace Gui {
 	*/
 	void clearTextBufs(void);
 
+	/*
+		Set the glyph budget of the Text Buffer.
+		The Text Buffer starts with 4096 glyphs and grows on demand up to this budget, instead of dropping glyphs.
+
+		maxGlyphs: The maximum amount of glyphs. (8192 by default.)
+	*/
+	void setTextBufBudget(size_t maxGlyphs);
+
+	/*
+		Get the Text Buffer statistics. 'clearTextBufs' counts as the end of a frame.
+		Measuring with 'GetStringWidth', 'GetStringHeight' or 'GetStringSize' does not use the Text Buffer.
+		Texts parsed on a Text Cache miss get their own buffer, but are still counted in 'lastFrame' and 'peak'.
+		Text Cache hits are not parsed again and therefore not counted.
+
+		lastFrame: Pointer where to store the glyphs parsed in the last frame. (Optional!)
+		peak: Pointer where to store the most glyphs parsed in a frame. (Optional!)
+		capacity: Pointer where to store the current size of the Text Buffer. (Optional!)
+		dropped: Pointer where to store the amount of glyphs which didn't fit into the budget. (Optional!)
+	*/
+	void getTextBufStats(size_t *lastFrame, size_t *peak, size_t *capacity, size_t *dropped);
+
+	/*
+		Reset the Text Buffer statistics.
+	*/
+	void resetTextBufStats(void);
+
+	#ifdef UC_DRAW_LOG
+	/*
+		Types of the recorded draw commands.
+	*/
+	enum class DrawCommandType : u8 {
+		SceneBegin, // source: The render target.
+		Rect, // x, y, w, h, color.
+		Sprite, // x, y, w: X-Scale, h: Y-Scale, source: The SpriteSheet, index: The image index.
+		Text, // x, y, w: X-Scale, h: Y-Scale, color, source: The Font, index: The flags, text.
+		Fade, // color: The fade overlay color with fadealpha as alpha.
+		Clip // x, y, w, h: The clip Rectangle, index: 1 for 'SetClip', 0 for 'ResetClip'.
+	};
+
+	/*
+		A recorded draw command.
+	*/
+	struct DrawCommand {
+		DrawCommandType type;
+		float x, y, w, h;
+		u32 color;
+		const void *source;
+		size_t index;
+		std::string text;
+	};
+
+	/*
+		Get the draw commands of the last finished frame. 'clearTextBufs' counts as the end of a frame.
+		Replayed DisplayLists are included, with the same commands as when they were recorded.
+		Only available with UC_DRAW_LOG defined.
+	*/
+	const std::vector<DrawCommand> &getDrawLog(void);
+
+	/*
+		Add a draw command to the draw log. Used by 'DisplayList' for its replays.
+		Only available with UC_DRAW_LOG defined.
+
+		command: The draw command.
+	*/
+	void logDrawCommand(const DrawCommand &command);
+	#endif
+
+	/*
+		Set the maximum amount of parsed Texts, which are kept in the Text Cache.
+		'DrawString' and 'DrawStringCentered' get their parsed Texts from there.
+
+		entries: The maximum amount of entries. 0 disables the cache. (128 by default.)
+	*/
+	void setTextCacheSize(size_t entries);
+
+	/*
+		Return the maximum amount of parsed Texts kept in the Text Cache.
+	*/
+	size_t getTextCacheSize(void);
+
+	/*
+		Clear the whole Text Cache, including the glyph metrics used by 'GetStringSize'.
+	*/
+	void clearTextCache(void);
+
+	/*
+		Drop all cached Texts and glyph metrics of a Font.
+		Call this, if you free or reload a Font yourself. 'unloadFont' and 'loadSystemFont' already do it.
+
+		fnt: The Font. nullptr means the loaded system font.
+	*/
+	void invalidateTextCache(C2D_Font fnt);
+
+	/*
+		Get the hit and miss counters of the Text Cache.
+
+		hits: Pointer where to store the amount of hits. (Optional!)
+		misses: Pointer where to store the amount of misses. (Optional!)
+	*/
+	void getTextCacheStats(size_t *hits, size_t *misses);
+
+	/*
+		Reset the hit and miss counters of the Text Cache.
+	*/
+	void resetTextCacheStats(void);
+
 	/*
 		Draw a sprite from a SpriteSheet.
 		sheet: The SpriteSheet which should be used.
@@ -50,6 +164,79 @@ namespace Gui {
 	*/
 	void DrawSprite(C2D_SpriteSheet sheet, size_t imgindex, int x, int y, float ScaleX = 1, float ScaleY = 1);
 
+	/*
+		Start queueing the sprites from 'DrawSprite', to submit them sorted by texture.
+		Overlapping sprites keep their order. Rectangles and Texts only submit the queued sprites first, if they overlap one of them,
+		so they stay in front of it. Anything else, like 'ScreenDraw', always submits them.
+	*/
+	void beginSpriteBatch(void);
+
+	/*
+		Submit the queued sprites and stop queueing.
+	*/
+	void endSpriteBatch(void);
+
+	/*
+		Submit the queued sprites, but keep queueing.
+	*/
+	void flushSpriteBatch(void);
+
+	/*
+		Get the sprite statistics of the last frame. 'clearTextBufs' counts as the end of a frame.
+
+		batches: Pointer where to store the amount of submitted sprite batches. (Optional!)
+		binds: Pointer where to store the amount of texture switches between sprites. (Optional!)
+	*/
+	void getSpriteStats(size_t *batches, size_t *binds);
+
+	/*
+		Return the amount of Rectangles, sprites and Texts drawn through the Gui namespace in the last frame.
+		Draws replayed from a display list count as well, once for every eye. Silent recordings don't count.
+	*/
+	size_t getDrawCount(void);
+
+	/*
+		Add draws to the count of the current frame. Used by 'DisplayList' for its replays.
+
+		count: The amount of draws.
+	*/
+	void countDraws(size_t count);
+
+	/*
+		Draw a widget, like a header or an info box, from a cached texture. (Optional!)
+		The first draw renders it into the texture, later ones only draw the texture, until 'invalidateCached' gets called.
+		Inside of a display list, the list keeps the texture alive for its replays, even after the cache dropped the widget.
+		Those textures don't count against the budget. Replays don't render invalidated widgets again, so invalidate the list as well.
+
+		key: The name of the widget.
+		x: The X-Position where to draw.
+		y: The Y-Position where to draw.
+		w: The width of the widget, up to 1024.
+		h: The height of the widget, up to 1024.
+		draw: Draws the widget through the Gui functions, with 0, 0 as its top left corner.
+		Returns false, if the texture could not be created. Nothing gets drawn then.
+	*/
+	bool drawCached(const std::string &key, float x, float y, int w, int h, const std::function<void()> &draw);
+
+	/*
+		Let a cached widget get rendered again on its next draw, after its content changed.
+
+		key: The name of the widget.
+	*/
+	void invalidateCached(const std::string &key);
+
+	/*
+		Set the maximum VRAM of the cached widgets, 4 bytes per pixel of their textures. The least recently drawn ones get dropped first.
+
+		bytes: The budget in bytes. 1 MiB by default.
+	*/
+	void setWidgetCacheBudget(size_t bytes);
+
+	/*
+		Drop all cached widgets.
+	*/
+	void clearWidgetCache(void);
+
 	/*
 		Initialize the GUI with Citro2D & Citro3D and initialize the Textbuffer.
 		call this when initializing.
@@ -67,6 +254,7 @@ namespace Gui {
 
 	/*
 		Load a Font. (BCFNT)
+		Goes through the asset registry, so loading the same file again shares the already loaded one.
 
 		fnt: The C2D_Font variable which should be initialized.
 		Path: Path to the BCFNT file.
@@ -83,6 +271,7 @@ namespace Gui {
 
 	/*
 		Load a spritesheet.
+		Goes through the asset registry, so loading the same file again shares the already loaded one.
 
 		Path: Path to the SpriteSheet file. (T3X)
 		sheet: Reference to the C2D_SpriteSheet declaration.
@@ -138,6 +327,24 @@ namespace Gui {
 	*/
 	void DrawString(float x, float y, float size, u32 color, const std::string &Text, int maxWidth = 0, int maxHeight = 0, C2D_Font fnt = nullptr, int flags = 0);
 
+	/*
+		Draws a String and returns the size it got drawn with.
+		The Text only gets parsed once, also if maxWidth or maxHeight is used, so prefer this over measuring and drawing separately.
+
+		x: The X Position where the Text should be drawn.
+		y: The Y Position where the Text should be drawn.
+		size: The size of the Text.
+		color: The Color of the Text.
+		Text: The Text which should be displayed.
+		width: Pointer where to store the drawn width. (Optional!)
+		height: Pointer where to store the drawn height. (Optional! Wrapped Text reports the unwrapped height.)
+		maxWidth: The maxWidth for the Text. (Optional!)
+		maxHeight: The maxHeight of the Text. (Optional!)
+		fnt: The Font which should be used. Uses SystemFont by default. (Optional!)
+		flags: C2D text flags to use.
+	*/
+	void DrawStringMeasured(float x, float y, float size, u32 color, const std::string &Text, float *width, float *height, int maxWidth = 0, int maxHeight = 0, C2D_Font fnt = nullptr, int flags = 0);
+
 	/*
 		Get the width of a String.
 
@@ -149,6 +356,7 @@ namespace Gui {
 
 	/*
 		Get the size of a String.
+		Measures with the glyph metrics of the Font, without parsing the Text into the Text Buffer.
 
 		size: The size of the Text.
 		width: The width of the Text.
@@ -178,12 +386,104 @@ namespace Gui {
 	*/
 	bool Draw_Rect(float x, float y, float w, float h, u32 color);
 
+	/*
+		A Rectangle for 'Draw_Rects'.
+	*/
+	struct Rect {
+		float x, y, w, h;
+		u32 color;
+	};
+
+	/*
+		An outlined Rectangle for 'Draw_Outlines'.
+	*/
+	struct Outline {
+		float x, y, w, h;
+		u32 color; // The outline color.
+		u32 bgColor; // The background color. Transparent skips the background.
+		float border; // The width of the outline.
+	};
+
+	/*
+		Draw multiple Rectangles in one pass. Rectangles without size or fully transparent ones get skipped.
+
+		rects: The Rectangles.
+		count: The amount of Rectangles.
+	*/
+	bool Draw_Rects(const Rect *rects, size_t count);
+
+	/*
+		Draw multiple outlined Rectangles in one pass, like a whole table of grids.
+		Fully transparent backgrounds and outlines get skipped.
+
+		outlines: The outlined Rectangles.
+		count: The amount of outlined Rectangles.
+	*/
+	bool Draw_Outlines(const Outline *outlines, size_t count);
+
+	/*
+		Only draw inside of a Rectangle of the current screen, until 'ResetClip'.
+		Uses the GPU scissor, so it also cuts Texts and sprites. Draws into textures don't get clipped.
+
+		x: X Position of the Rectangle.
+		y: Y Position of the Rectangle.
+		w: The width of the Rectangle.
+		h: The height of the Rectangle.
+	*/
+	void SetClip(float x, float y, float w, float h);
+	void ResetClip(void);
+
 	/*
 		Used for the current Screen's Draw. (Optional!)
 		stack: Is it the stack variant?
 	*/
 	void DrawScreen(bool stack = false);
 
+	/*
+		Turn the stereoscopic 3D mode on or off. (Optional!)
+
+		enable: If the 3D mode should be used.
+		maxParallax: The offset in pixels for each eye of a draw with a depth of 1, with the 3D slider at the top. (Optional!)
+		clearColor: The color 'DrawScreen' clears 'TopRight' with, use the one 'Top' gets cleared with. (Optional!)
+		While the slider is up, 'DrawScreen' runs 'Screen::Draw' once and replays the Top screen part to 'Top' and 'TopRight'.
+		Screens don't need to draw to 'TopRight' themselves, nor clear it. Retained screens replay their list, others get recorded every frame.
+	*/
+	void setStereo(bool enable, float maxParallax = 4.0f, u32 clearColor = C2D_Color32(0, 0, 0, 255));
+
+	/*
+		Set the stereoscopic depth of the following draws. 'ScreenDraw' resets it to 0. (Optional!)
+
+		depth: The depth. Positive comes out of the screen, negative goes into it.
+	*/
+	void setDepth(float depth);
+
+	/*
+		Enable or disable frame pacing. (Optional!)
+		With pacing enabled, 'frameNeedsRender' skips frames without input, fade or screen animation.
+
+		enable: If frames without changes should be skipped.
+		idleInterval: Still render every Nth idle frame, for example for a clock. 0 never renders idle frames. (Optional!)
+		wakeFrames: The amount of frames, which get rendered at full rate after the last input. (Optional!)
+	*/
+	void setFramePacing(bool enable, int idleInterval = 0, int wakeFrames = 30);
+
+	/*
+		Return if the current frame has to be rendered. Always true, if frame pacing is disabled.
+		If it returns false, skip C3D_FrameBegin / C3D_FrameEnd and call gspWaitForVBlank() instead,
+		the previously rendered frame then simply stays on the screens.
+
+		hDown: the hidKeysDown() variable.
+		hHeld: the HidKeysHeld() variable.
+		stack: Is it the stack variant?
+	*/
+	bool frameNeedsRender(u32 hDown, u32 hHeld, bool stack = false);
+
+	/*
+		Let the next frame get rendered, even if nothing changed.
+		Call this after changes that don't come from input, like a finished download. Only from the main thread.
+	*/
+	void requestRedraw(void);
+
 	/*
 		Used for the current Screen's Logic. (Optional!)
 
@@ -193,6 +493,7 @@ namespace Gui {
 		touch: The TouchPosition variable.
 		waitFade: Wheter to wait until the fade ends.
 		stack: Is it the stack variant?
+		Event driven screens get the input events of this frame through 'Screen::OnEvent' instead of 'Screen::Logic'.
 	*/
 	#ifdef UC_KEY_REPEAT
 	void ScreenLogic(u32 hDown, u32 hDownRepeat, u32 hHeld, touchPosition touch, bool waitFade = true, bool stack = false);
@@ -200,6 +501,27 @@ namespace Gui {
 	void ScreenLogic(u32 hDown, u32 hHeld, touchPosition touch, bool waitFade = true, bool stack = false);
 	#endif
 
+	/*
+		Queue an input event for the next 'Gui::ScreenLogic', for example from input sampled more than once per frame.
+		Consecutive TouchMove events get merged into one.
+
+		event: The event.
+	*/
+	void pushInputEvent(const InputEvent &event);
+
+	/*
+		Turn the threaded logic on or off. (Optional!)
+		'ScreenLogic' then hands the Logic of screens with 'Screen::Threaded' to its own thread and returns,
+		so it runs while the frame gets drawn. The next 'ScreenLogic' waits for it and calls 'Screen::Publish'.
+		See 'Screen::Threaded' for what the Logic may do on its thread.
+		With the host layer in 'host/', the logic thread is an ordinary thread, so screens can be checked with a thread sanitizer on a PC.
+
+		enable: If the logic of threaded screens should run on its own thread.
+		core: The CPU core of the logic thread. 1 is the system core, which needs 'APT_SetAppCpuTimeLimit' first. (Optional!)
+		Returns false, if the thread could not be created.
+	*/
+	bool setThreadedLogic(bool enable, int core = 1);
+
 	/*
 		Transfer the Temp Screen to the used one. (Optional!)
 
@@ -217,10 +539,24 @@ namespace Gui {
 	*/
 	void setScreen(std::unique_ptr<Screen> screen, bool fade = false, bool stack = false);
 
+	/*
+		Set a specific Screen, which gets constructed on a worker thread during the fadeout. (Optional!)
+
+		factory: Function returning the new screen, like '[]() { return std::make_unique<MainMenu>(); }'.
+		fade: Whether to fade. Without it, the factory runs right away on the calling thread.
+		stack: Is it the stack variant?
+		'Gui::transferScreen' only waits for the factory, if it didn't finish during the fadeout yet.
+		The factory runs next to the main thread, which keeps drawing the fade. It may load Sheets and Fonts
+		('loadSheet', 'acquireSheet', 'loadSheetAsync' & co) and measure Texts ('GetStringWidth' & co), those are locked.
+		It must not draw, switch screens, start Animations or touch the state of the current screen.
+	*/
+	void setScreenDeferred(std::function<std::unique_ptr<Screen>()> factory, bool fade = true, bool stack = false);
+
 	/*
 		Fades into screens and calls the constructor after it. (Optional!)
-		fadeoutFrames: Amount of frames for fadeout.
-		fadeinFrames: Amount of frames for fadein.
+		Runs on the Animation scheduler, so the fade takes the same time, even if frames get dropped.
+		fadeoutFrames: The alpha step per frame at 60 FPS for fadeout.
+		fadeinFrames: The alpha step per frame at 60 FPS for fadein.
 		stack: Is it the stack variant?
 	*/
 	void fadeEffects(int fadeoutFrames = 6, int fadeinFrames = 6, bool stack = false);
@@ -228,6 +564,43 @@ namespace Gui {
 	void screenBack(bool fade = false); // Goes a screen back. (Set!) (Stack only!)
 	void screenBack2(); // Goes a screen back.(Action!) (Stack only!)
 
+	/*
+		Set the memory budget of the screen cache. (Optional!)
+
+		bytes: The maximum of the summed up 'Screen::CacheBytes'. 0 disables the cache, which is the default.
+		Popped screens with a 'Screen::CacheId' get suspended and kept, the least recently popped ones get destroyed first.
+	*/
+	void setScreenCacheBudget(size_t bytes);
+
+	/*
+		Destroy all screens in the screen cache.
+	*/
+	void clearScreenCache(void);
+
+	/*
+		Take a screen out of the screen cache and resume it.
+
+		type: The type of the screen class.
+		id: The 'Screen::CacheId' of the screen.
+		Returns nullptr, if it is not cached.
+	*/
+	std::unique_ptr<Screen> takeCachedScreen(std::type_index type, int id);
+
+	/*
+		Return the cached screen or construct a new one, for 'Gui::setScreen'.
+
+		id: The 'Screen::CacheId' of the screen.
+		args: The arguments for the constructor, if it is not cached.
+		Example: 'Gui::setScreen(Gui::reuseScreen<Settings>(0), true, true);'.
+	*/
+	template <typename T, typename... Args>
+	std::unique_ptr<Screen> reuseScreen(int id, Args &&... args) {
+		std::unique_ptr<Screen> screen = takeCachedScreen(typeid(T), id);
+		if (!screen) screen = std::make_unique<T>(std::forward<Args>(args)...);
+
+		return screen;
+	};
+
 	/*
 		Set on which screen to draw.
 
@@ -252,7 +625,7 @@ namespace Gui {
 		yPos: Y Position of the Selector.
 		Width: Width of the Selector.
 		Height: Height of the Selector.
-		speed: The speed of the animation. (Use .030f or something by default.)
+		speed: The speed of the animation per frame at 60 FPS. (Use .030f or something by default.)
 		SelectorColor: The Color of the Selector outline.
 		bgColor: The BG Color from the selector. (Optional! It's transparent by default.)
 	*/
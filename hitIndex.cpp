@@ -0,0 +1,188 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "hitIndex.hpp"
+
+#include <algorithm>
+
+HitIndex::HitIndex(int width, int height, int cellSize) : width(width), height(height), cellSize(cellSize) {
+	this->cols = (width + cellSize - 1) / cellSize;
+	this->rows = (height + cellSize - 1) / cellSize;
+	this->cells.resize(this->cols * this->rows);
+}
+
+/*
+	Get the range of cells a button covers.
+
+	const Structs::ButtonPos &pos: The position of the button.
+	int &x1, &y1, &x2, &y2: The first and last column and row.
+
+	Returns false, if the button doesn't start inside of the grid.
+	Buttons reaching past the right or bottom edge get clamped to the last column and row.
+*/
+bool HitIndex::CellRange(const Structs::ButtonPos &pos, int &x1, int &y1, int &x2, int &y2) const {
+	if (pos.x < 0 || pos.y < 0 || pos.x >= this->width || pos.y >= this->height || pos.w < 0 || pos.h < 0) return false;
+
+	/* 'Touched' includes the right and bottom edge. */
+	x1 = pos.x / this->cellSize;
+	y1 = pos.y / this->cellSize;
+	x2 = std::min((pos.x + pos.w) / this->cellSize, this->cols - 1);
+	y2 = std::min((pos.y + pos.h) / this->cellSize, this->rows - 1);
+	return true;
+}
+
+/*
+	Add a button to the cells it covers.
+
+	int id: The ID of the button.
+*/
+void HitIndex::Link(int id) {
+	int x1, y1, x2, y2;
+
+	if (!this->CellRange(this->entries[id].pos, x1, y1, x2, y2)) {
+		this->outside.push_back(id);
+		return;
+	}
+
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) this->cells[y * this->cols + x].push_back(id);
+	}
+}
+
+/*
+	Remove a button from the cells it covers.
+
+	int id: The ID of the button.
+*/
+void HitIndex::Unlink(int id) {
+	int x1, y1, x2, y2;
+
+	if (!this->CellRange(this->entries[id].pos, x1, y1, x2, y2)) {
+		this->outside.erase(std::find(this->outside.begin(), this->outside.end(), id));
+		return;
+	}
+
+	for (int y = y1; y <= y2; y++) {
+		for (int x = x1; x <= x2; x++) {
+			std::vector<int> &cell = this->cells[y * this->cols + x];
+			cell.erase(std::find(cell.begin(), cell.end(), id));
+		}
+	}
+}
+
+/*
+	Add a button.
+
+	int id: The ID of the button.
+	const Structs::ButtonPos &pos: The position of the button.
+*/
+void HitIndex::Insert(int id, const Structs::ButtonPos &pos) {
+	if (id < 0) return;
+
+	if ((size_t)id >= this->entries.size()) this->entries.resize(id + 1, { { 0, 0, 0, 0 }, 0, false });
+	if (this->entries[id].used) this->Unlink(id);
+
+	this->entries[id] = { pos, this->nextOrder++, true };
+	this->Link(id);
+}
+
+/*
+	Add keyboard keys.
+
+	const std::vector<Structs::Key> &keys: The keys.
+	int keyHeight: The height of the keys.
+	int firstId: The ID of the first key.
+*/
+void HitIndex::InsertKeys(const std::vector<Structs::Key> &keys, int keyHeight, int firstId) {
+	for (size_t i = 0; i < keys.size(); i++) this->Insert(firstId + i, { keys[i].x, keys[i].y, keys[i].w, keyHeight });
+}
+
+/*
+	Move a button.
+
+	int id: The ID of the button.
+	const Structs::ButtonPos &pos: The new position of the button.
+*/
+void HitIndex::Update(int id, const Structs::ButtonPos &pos) {
+	if (id < 0 || (size_t)id >= this->entries.size() || !this->entries[id].used) return;
+
+	this->Unlink(id);
+	this->entries[id].pos = pos;
+	this->Link(id);
+}
+
+/*
+	Remove a button.
+
+	int id: The ID of the button.
+*/
+void HitIndex::Remove(int id) {
+	if (id < 0 || (size_t)id >= this->entries.size() || !this->entries[id].used) return;
+
+	this->Unlink(id);
+	this->entries[id].used = false;
+}
+
+/*
+	Remove all buttons.
+*/
+void HitIndex::Clear() {
+	for (std::vector<int> &cell : this->cells) cell.clear();
+	this->outside.clear();
+	this->entries.clear();
+	this->nextOrder = 0;
+}
+
+/*
+	Return the ID of the topmost touched button, or -1.
+
+	const touchPosition &touch: The touchPosition variable.
+*/
+int HitIndex::Hit(const touchPosition &touch) const {
+	const int tx = touch.px + this->offsetX, ty = touch.py + this->offsetY;
+	int hit = -1;
+	u32 order = 0;
+
+	/* Same check as 'Structs::ButtonPos::Touched', but with the offset applied. */
+	auto check = [&](int id) {
+		const Entry &entry = this->entries[id];
+
+		if ((hit == -1 || entry.order > order) && (tx >= entry.pos.x && tx <= (entry.pos.x + entry.pos.w)) && (ty >= entry.pos.y && ty <= (entry.pos.y + entry.pos.h))) {
+			hit = id;
+			order = entry.order;
+		}
+	};
+
+	/* Past the right or bottom edge, the last column or row has all the buttons reaching there. */
+	if (tx >= 0 && ty >= 0) {
+		const int col = std::min(tx / this->cellSize, this->cols - 1), row = std::min(ty / this->cellSize, this->rows - 1);
+		for (int id : this->cells[row * this->cols + col]) check(id);
+	}
+
+	for (int id : this->outside) check(id);
+
+	return hit;
+}
@@ -0,0 +1,119 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_HIT_INDEX_HPP
+#define _UNIVERSAL_CORE_HIT_INDEX_HPP
+
+#include "structs.hpp"
+
+#include <vector>
+
+/*
+	A uniform grid over ButtonPos rectangles for touch hit-testing.
+
+	Instead of checking every button with 'Touched', only the buttons in the touched grid cell get checked.
+	Buttons inserted later lay on top of earlier ones, like they would when drawn in that order.
+*/
+class HitIndex {
+public:
+	/*
+		width: The width of the covered area. (Optional! The bottom screen by default.)
+		height: The height of the covered area. (Optional!)
+		cellSize: The size of a grid cell in pixels. (Optional!)
+	*/
+	HitIndex(int width = 320, int height = 240, int cellSize = 16);
+
+	/*
+		Add a button. Replaces the button, if the ID is already used.
+
+		id: The ID of the button, which 'Hit' returns. Must not be negative.
+		pos: The position of the button.
+	*/
+	void Insert(int id, const Structs::ButtonPos &pos);
+
+	/*
+		Add keyboard keys. The key at index i gets the ID firstId + i.
+
+		keys: The keys.
+		keyHeight: The height of the keys.
+		firstId: The ID of the first key. (Optional!)
+	*/
+	void InsertKeys(const std::vector<Structs::Key> &keys, int keyHeight, int firstId = 0);
+
+	/*
+		Move a button, for example when it scrolls. It keeps its place in the stacking order.
+
+		id: The ID of the button.
+		pos: The new position of the button.
+	*/
+	void Update(int id, const Structs::ButtonPos &pos);
+
+	/*
+		Remove a button.
+
+		id: The ID of the button.
+	*/
+	void Remove(int id);
+
+	/*
+		Remove all buttons.
+	*/
+	void Clear();
+
+	/*
+		Set an offset, which gets added to the touch position. Use this for scrolled content, instead of moving all buttons.
+
+		x: The X offset.
+		y: The Y offset.
+	*/
+	void SetOffset(int x, int y) { this->offsetX = x; this->offsetY = y; };
+
+	/*
+		Return the ID of the topmost touched button, or -1 if none got touched.
+
+		touch: The touchPosition variable.
+	*/
+	int Hit(const touchPosition &touch) const;
+private:
+	struct Entry {
+		Structs::ButtonPos pos;
+		u32 order;
+		bool used;
+	};
+
+	void Link(int id);
+	void Unlink(int id);
+	bool CellRange(const Structs::ButtonPos &pos, int &x1, int &y1, int &x2, int &y2) const;
+
+	std::vector<Entry> entries; // Indexed by the ID.
+	std::vector<std::vector<int>> cells;
+	std::vector<int> outside; // Buttons which don't start inside of the grid.
+	int width, height, cellSize, cols, rows;
+	int offsetX = 0, offsetY = 0;
+	u32 nextOrder = 0;
+};
+
+#endif
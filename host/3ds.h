@@ -0,0 +1,120 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+
+/*
+	Host stand-in for libctru's <3ds.h>.
+
+	Only declares what Universal-Core and ordinary screens use, so they can be compiled and run on a PC.
+	The implementation is in 'host.cpp', see 'host.hpp' for how to build and drive it.
+*/
+
+#ifndef _UNIVERSAL_CORE_HOST_3DS_H
+#define _UNIVERSAL_CORE_HOST_3DS_H
+
+#include "3ds/types.h"
+#include "3ds/services/hid.h"
+
+/* System. A fixed type, so it can hold the '(CFG_Region)-1' Gui uses for "no font loaded". */
+typedef enum : int {
+	CFG_REGION_JPN = 0, CFG_REGION_USA = 1, CFG_REGION_EUR = 2, CFG_REGION_AUS = 3,
+	CFG_REGION_CHN = 4, CFG_REGION_KOR = 5, CFG_REGION_TWN = 6
+} CFG_Region;
+
+#define SYSCLOCK_ARM11 268111856
+#define CUR_THREAD_HANDLE 0xFFFF8000
+
+u64 svcGetSystemTick(void);
+Result svcGetThreadPriority(s32 *out, Handle handle);
+void svcSleepThread(s64 ns);
+u64 osGetTime(void);
+float osGet3DSliderState(void);
+bool aptMainLoop(void);
+Result romfsInit(void);
+Result romfsExit(void);
+ssize_t decode_utf8(uint32_t *out, const uint8_t *in);
+
+/* System font glyphs. */
+typedef struct {
+	int sheetIndex;
+	float xOffset;
+	float xAdvance;
+	float width;
+	struct { float left, top, right, bottom; } texcoord;
+	struct { float left, top, right, bottom; } vtxcoord;
+} fontGlyphPos_s;
+
+/* Graphics. */
+typedef enum { GFX_TOP = 0, GFX_BOTTOM = 1 } gfxScreen_t;
+typedef enum { GFX_LEFT = 0, GFX_RIGHT = 1 } gfx3dSide_t;
+
+void gfxInitDefault(void);
+void gfxExit(void);
+void gfxSet3D(bool enable);
+bool gfxIs3D(void);
+void gspWaitForVBlank(void);
+
+/* Threads, real ones on the host. */
+typedef struct Thread_tag *Thread;
+typedef void (*ThreadFunc)(void *arg);
+
+Thread threadCreate(ThreadFunc entrypoint, void *arg, size_t stack_size, int prio, int core_id, bool detached);
+Result threadJoin(Thread thread, u64 timeout_ns);
+void threadFree(Thread thread);
+Thread threadGetCurrent(void);
+
+typedef s32 LightLock;
+void LightLock_Init(LightLock *lock);
+void LightLock_Lock(LightLock *lock);
+int LightLock_TryLock(LightLock *lock);
+void LightLock_Unlock(LightLock *lock);
+
+typedef struct {
+	LightLock lock;
+	u32 thread_tag;
+	u32 counter;
+} RecursiveLock;
+
+void RecursiveLock_Init(RecursiveLock *lock);
+void RecursiveLock_Lock(RecursiveLock *lock);
+int RecursiveLock_TryLock(RecursiveLock *lock);
+void RecursiveLock_Unlock(RecursiveLock *lock);
+
+typedef enum { RESET_ONESHOT = 0, RESET_STICKY = 1, RESET_PULSE = 2 } ResetType;
+
+typedef struct {
+	s32 state;
+	LightLock lock;
+} LightEvent;
+
+void LightEvent_Init(LightEvent *event, ResetType reset_type);
+void LightEvent_Clear(LightEvent *event);
+void LightEvent_Signal(LightEvent *event);
+int LightEvent_TryWait(LightEvent *event);
+void LightEvent_Wait(LightEvent *event);
+int LightEvent_WaitTimeout(LightEvent *event, s64 timeout_ns);
+
+#endif
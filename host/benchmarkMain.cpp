@@ -0,0 +1,58 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "benchmark.hpp"
+#include "gui.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+/*
+	Run the benchmarks on the host, see 'Benchmark::run' and 'make benchmark'.
+
+	benchmark [json] [baseline json] [iterations] [sheet]
+
+	Without a sheet, the DrawSprite benchmark uses a SpriteSheet of 32x32 host images.
+*/
+int main(int argc, char *argv[]) {
+	const std::string jsonPath = argc > 1 ? argv[1] : "benchmark.json";
+	const std::string baselinePath = argc > 2 ? argv[2] : "";
+	const u32 iterations = argc > 3 ? strtoul(argv[3], nullptr, 10) : 4096;
+
+	Gui::init();
+	C2D_SpriteSheet sheet = argc > 4 ? C2D_SpriteSheetLoad(argv[4]) : C2D_SpriteSheetLoadFromMem("sheet", 5);
+
+	const std::vector<Benchmark::Result> results = Benchmark::run(jsonPath, baselinePath, sheet, iterations);
+	for (const Benchmark::Result &result : results) {
+		printf("%-40s %10.1f ns/op %8.3f allocs/op", result.name.c_str(), result.nsPerOp, result.allocsPerOp);
+		if (result.baselineNsPerOp > 0) printf(" %+7.1f%%", (result.nsPerOp - result.baselineNsPerOp) * 100.0 / result.baselineNsPerOp);
+		putchar('\n');
+	}
+
+	if (sheet) C2D_SpriteSheetFree(sheet);
+	Gui::exit();
+	return 0;
+}
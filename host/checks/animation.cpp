@@ -0,0 +1,64 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "animation.hpp"
+
+#include <vector>
+
+/*
+	A done callback may stop another animation, which finished in the same update.
+	Starting more than 'MAX_RUNNING' animations fails, instead of handing out IDs of running ones.
+*/
+int main() {
+	Animation::Id first = 0, second = 0, started = 0;
+	int calls = 0;
+
+	first = Animation::start(0, 1, 0.1f, Animation::Ease::Linear, [&]() {
+		calls++;
+		Animation::stop(second);
+		started = Animation::start(0, 1, 5.0f, Animation::Ease::Linear, nullptr, false);
+	}, false);
+	second = Animation::start(0, 1, 0.1f, Animation::Ease::Linear, [&]() { calls += 10; }, false);
+
+	Animation::update(0.2f);
+	CHECK(calls == 1);
+	CHECK(!Animation::running(first));
+	CHECK(Animation::running(started));
+
+	Animation::stop(started);
+	CHECK(!Animation::anyRunning());
+
+	std::vector<Animation::Id> ids;
+	for (size_t i = 0; i < Animation::MAX_RUNNING; i++) ids.push_back(Animation::start(0, 1, 1.0f));
+	CHECK(ids.front() != 0 && ids.back() != 0);
+	CHECK(Animation::start(0, 1, 1.0f) == 0);
+	CHECK(Animation::running(ids.front()));
+
+	for (Animation::Id id : ids) Animation::stop(id);
+	CHECK(Animation::start(0, 1, 1.0f) != 0); // The slots get reused.
+	return 0;
+}
@@ -0,0 +1,54 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "asyncLoader.hpp"
+#include "gui.hpp"
+
+/*
+	Acquired assets survive 'Gui::exit', queued ones fail instead of blocking.
+*/
+int main() {
+	FILE *file = fopen("assets.t3x", "wb");
+	fputs("sheet", file);
+	fclose(file);
+
+	Gui::init();
+	C2D_SpriteSheet sheet = Gui::acquireSheet("assets.t3x");
+	C2D_SpriteSheet second = Gui::acquireSheet("assets.t3x");
+	std::shared_ptr<AsyncAsset> queued = Gui::loadSheetAsync("assets.t3x");
+	CHECK(sheet && sheet == second);
+	Gui::exit();
+
+	queued->Wait();
+	CHECK(queued->Ready() || queued->Failed());
+
+	/* Registry sheets get free'd with the last release, ASan catches double frees. */
+	Gui::unloadSheet(second);
+	Gui::unloadSheet(sheet);
+	CHECK(!Gui::releaseSheet(sheet));
+	return 0;
+}
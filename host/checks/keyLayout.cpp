@@ -0,0 +1,56 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "keyLayout.hpp"
+
+#include <vector>
+
+/*
+	'KeyLayout::Hit' finds keys of staggered rows and overlapping keys, like drawn.
+*/
+int main() {
+	Gui::init();
+
+	/* "B" sits lower than "A" in the same row, "D" overlaps "C" and is drawn on top of it. */
+	const std::vector<Structs::Key> keys = {
+		{ "A", 0, 0, 30 }, { "B", 30, 10, 30 }, { "C", 0, 40, 40 }, { "D", 30, 40, 30 }
+	};
+	KeyLayout layout(keys, 30);
+
+	CHECK(layout.Hit({ 10, 10 }) == 0);
+	CHECK(layout.Hit({ 10, 20 }) == 0); // Below the top of "B"'s row.
+	CHECK(layout.Hit({ 40, 5 }) == -1);
+	CHECK(layout.Hit({ 40, 35 }) == 1);
+	CHECK(layout.Hit({ 10, 50 }) == 2);
+	CHECK(layout.Hit({ 35, 50 }) == 3);
+	CHECK(layout.Hit({ 100, 100 }) == -1);
+	CHECK(layout.Label(3) == "D");
+
+	Gui::exit();
+	return 0;
+}
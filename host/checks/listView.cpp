@@ -0,0 +1,86 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "listView.hpp"
+#include "screenCommon.hpp"
+
+#include <string>
+
+/*
+	Rows cut by the edges of a ListView still get their text, clipped by the scissor. Long texts get shortened to fit.
+*/
+int main() {
+	Gui::init();
+
+	/* 6 pixels per glyph at 0.5, so 12 glyphs and "..." fit into 100 - 8 pixels. */
+	ListView list({ 10, 20, 100, 50 }, 20);
+	list.SetSource(10, [](size_t index) { return index == 1 ? "äbcdefghijklmnopqrstuvwxyz" : "Row " + std::to_string(index); });
+
+	Host::clearCommands();
+	Gui::ScreenDraw(Bottom);
+	list.Draw();
+
+	/* Rows 0 and 1 are whole, row 2 is cut at the bottom. */
+	int texts = 0, scissors = 0;
+	for (const Host::Command &command : Host::getCommands()) {
+		if (command.type == Host::CommandType::Text) {
+			CHECK(scissors == 1);
+			if (texts == 1) CHECK(command.text == "äbcdefghijkl...");
+			texts++;
+
+		} else if (command.type == Host::CommandType::Scissor) {
+			if (scissors == 0) {
+				CHECK(command.flags == GPU_SCISSOR_NORMAL);
+				CHECK(command.x == 240 - 70 && command.y == 320 - 110 && command.w == 240 - 20 && command.h == 320 - 10);
+
+			} else {
+				CHECK(command.flags == GPU_SCISSOR_DISABLE);
+			}
+
+			scissors++;
+		}
+	}
+
+	CHECK(texts == 3 && scissors == 2);
+
+	/* Whole rows only don't need the scissor. */
+	list.SetSource(2, [](size_t index) { return "Row " + std::to_string(index); });
+	Host::clearCommands();
+	list.Draw();
+
+	texts = scissors = 0;
+	for (const Host::Command &command : Host::getCommands()) {
+		texts += command.type == Host::CommandType::Text;
+		scissors += command.type == Host::CommandType::Scissor;
+	}
+
+	CHECK(texts == 2 && scissors == 0);
+
+	Gui::exit();
+	return 0;
+}
@@ -0,0 +1,69 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "inputRecord.hpp"
+#include "screenCommon.hpp"
+
+/*
+	Recorded input replays without a display, and replayed display lists count as draws.
+*/
+class ReplayScreen : public Screen {
+public:
+	ReplayScreen(bool retained) : retained(retained) { };
+
+	bool Retained() const override { return this->retained; };
+	void Logic(u32, u32, touchPosition) override { };
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		Gui::Draw_Rect(10, 0, 5, 5, C2D_Color32(255, 255, 255, 255));
+		Gui::DrawString(0, 0, 0.5f, C2D_Color32(255, 255, 255, 255), "Replay");
+	};
+private:
+	bool retained;
+};
+
+int main() {
+	Gui::init();
+
+	CHECK(InputRecord::startRecording("replay.rec"));
+	for (int frame = 0; frame < 10; frame++) InputRecord::addFrame(frame == 5 ? (u32)KEY_A : 0, 0, 0, { 0, 0 });
+	InputRecord::stopRecording();
+
+	for (bool retained : { false, true }) {
+		Gui::setScreen(std::make_unique<ReplayScreen>(retained));
+
+		InputRecord::Report report = { };
+		CHECK(InputRecord::replay("replay.rec", report));
+		CHECK(report.frames == 10);
+		CHECK(report.drawsAverage == 2 && report.drawsMax == 2);
+		CHECK(report.fadeMismatches == 0);
+	}
+
+	Gui::exit();
+	return 0;
+}
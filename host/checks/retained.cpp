@@ -0,0 +1,66 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "screenCommon.hpp"
+
+/*
+	Fades draw a retained screen directly, but its named parts keep getting replayed.
+*/
+static int partDraws = 0;
+
+class RetainedScreen : public Screen {
+public:
+	bool Retained() const override { return true; };
+	void Logic(u32, u32, touchPosition) override { };
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		this->Retain("part", []() {
+			partDraws++;
+			Gui::Draw_Rect(0, 0, 5, 5, C2D_Color32(255, 255, 255, 255));
+		});
+	};
+};
+
+int main() {
+	Gui::init();
+	Gui::setScreen(std::make_unique<RetainedScreen>());
+
+	Gui::DrawScreen(); // Draws the part into the whole screen list.
+	CHECK(partDraws == 1);
+
+	fadein = true;
+	for (int frame = 0; frame < 5; frame++) Gui::DrawScreen(); // Records the part once, then replays it.
+	CHECK(partDraws == 2);
+
+	fadein = false;
+	Gui::DrawScreen(); // Records the whole screen list again.
+	Gui::DrawScreen();
+	CHECK(partDraws == 3);
+
+	Gui::exit();
+	return 0;
+}
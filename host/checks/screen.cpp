@@ -0,0 +1,75 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "screenCommon.hpp"
+
+/*
+	Input reaches 'Logic' and the draws of 'Draw' reach citro2d, with UTF-8 Texts intact.
+*/
+class TestScreen : public Screen {
+public:
+	int presses = 0;
+
+	void Logic(u32 hDown, u32, touchPosition) override { if (hDown & KEY_A) this->presses++; };
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		Gui::Draw_Rect(0, 0, 400, 240, C2D_Color32(0, 255, 0, 255));
+		Gui::DrawString(10, 10, 0.5f, C2D_Color32(255, 255, 255, 255), "Hällo\nWorld");
+	};
+};
+
+int main() {
+	Gui::init();
+	std::unique_ptr<TestScreen> screen = std::make_unique<TestScreen>();
+	TestScreen *test = screen.get();
+	Gui::setScreen(std::move(screen));
+
+	for (int frame = 0; frame < 3; frame++) {
+		Host::setInput(frame == 1 ? (u32)KEY_A : 0, { 0, 0 });
+		hidScanInput();
+		touchPosition touch;
+		hidTouchRead(&touch);
+		Gui::ScreenLogic(hidKeysDown(), hidKeysHeld(), touch, true);
+
+		C3D_FrameBegin(C3D_FRAME_SYNCDRAW);
+		Host::clearCommands();
+		Gui::DrawScreen();
+		C3D_FrameEnd(0);
+		Gui::clearTextBufs();
+	}
+
+	CHECK(test->presses == 1);
+	CHECK(Host::getFrameCount() == 3);
+	CHECK(Host::getCommands().back().type == Host::CommandType::Text);
+	CHECK(Host::getCommands().back().text == "Hällo\nWorld");
+	CHECK(Gui::GetStringWidth(1.0f, "abc") == 3 * Host::GLYPH_WIDTH);
+	CHECK(Gui::getDrawCount() == 2);
+
+	Gui::exit();
+	return 0;
+}
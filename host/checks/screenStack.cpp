@@ -0,0 +1,72 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "screenCommon.hpp"
+
+#include <string>
+
+/*
+	A screen switch queued by a threaded 'Logic' doesn't get mixed into a screen switch of the main thread.
+*/
+static std::string drawn;
+
+class StackScreen : public Screen {
+public:
+	StackScreen(const std::string &name, bool push) : name(name), push(push) { };
+
+	bool Threaded() const override { return true; };
+	void Logic(u32, u32, touchPosition) override {
+		if (this->push) Gui::setScreen(std::make_unique<StackScreen>("pushed", false), false, true);
+		this->push = false;
+	};
+	void Draw() const override { drawn = this->name; };
+private:
+	std::string name;
+	bool push;
+};
+
+int main() {
+	Gui::init();
+	CHECK(Gui::setThreadedLogic(true));
+
+	Gui::setScreen(std::make_unique<StackScreen>("root", false), false, true);
+	Gui::setScreen(std::make_unique<StackScreen>("left", true), false, true);
+
+	Gui::ScreenLogic(0, 0, { 0, 0 }, false, true); // Queues the push.
+	Gui::screenBack(); // Leaves "left".
+	Gui::ScreenLogic(0, 0, { 0, 0 }, false, true); // Does the push.
+
+	Gui::DrawScreen(true);
+	CHECK(drawn == "pushed");
+
+	Gui::screenBack();
+	Gui::DrawScreen(true);
+	CHECK(drawn == "root");
+
+	Gui::exit();
+	return 0;
+}
@@ -0,0 +1,109 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "screenCommon.hpp"
+
+#include <vector>
+
+/*
+	Batched sprites may get reordered, but never past a sprite, Rectangle or Text they overlap.
+*/
+struct Call {
+	float left, top, right, bottom;
+	bool sprite;
+};
+
+int main() {
+	Gui::init();
+
+	C2D_SpriteSheet sheets[3];
+	for (C2D_SpriteSheet &sheet : sheets) sheet = C2D_SpriteSheetLoadFromMem("x", 1); // 32x32 fallback images.
+
+	std::vector<Call> calls;
+	srand(5);
+
+	/* Rectangles and Texts carry their call index in the color, sprites get found by their position. */
+	Host::clearCommands();
+	Gui::beginSpriteBatch();
+	for (u32 i = 0; i < 300; i++) {
+		const int kind = rand() % 10;
+		const float x = rand() % 300 + (i + 1) / 1000.0f, y = rand() % 200;
+
+		if (kind < 6) {
+			Gui::DrawSprite(sheets[kind % 3], 0, x, y);
+			calls.push_back({ (float)(int)x, y, (int)x + 32.0f, y + 32, true });
+
+		} else if (kind < 8) {
+			Gui::Draw_Rect(x, y, 20, 10, 0xFF000000 | i);
+			calls.push_back({ x, y, x + 20, y + 10, false });
+
+		} else {
+			Gui::DrawString(x, y, 0.5f, 0xFF000000 | i, "abc");
+			calls.push_back({ x, y, x + 18, y + 15, false });
+		}
+	}
+	Gui::endSpriteBatch();
+
+	std::vector<int> drawn(calls.size(), -1);
+	int position = 0;
+
+	for (const Host::Command &command : Host::getCommands()) {
+		int index = -1;
+
+		if (command.type == Host::CommandType::Rect || command.type == Host::CommandType::Text) {
+			index = command.color & 0xFFFFFF;
+
+		} else if (command.type == Host::CommandType::Image) {
+			for (size_t i = 0; i < calls.size(); i++) {
+				if (calls[i].sprite && drawn[i] < 0 && calls[i].left == command.x && calls[i].top == command.y) {
+					index = i;
+					break;
+				}
+			}
+
+		} else {
+			continue;
+		}
+
+		CHECK(index >= 0 && drawn[index] < 0);
+		drawn[index] = position++;
+	}
+
+	CHECK(position == (int)calls.size());
+
+	for (size_t a = 0; a < calls.size(); a++) {
+		for (size_t b = a + 1; b < calls.size(); b++) {
+			const bool overlap = calls[a].left < calls[b].right && calls[b].left < calls[a].right && calls[a].top < calls[b].bottom && calls[b].top < calls[a].bottom;
+			CHECK(!overlap || drawn[a] < drawn[b]);
+		}
+	}
+
+	for (C2D_SpriteSheet sheet : sheets) C2D_SpriteSheetFree(sheet);
+	Gui::exit();
+	return 0;
+}
@@ -0,0 +1,82 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "screenCommon.hpp"
+
+/*
+	With the 3D slider up, TopRight gets cleared and the Top screen gets drawn for both eyes.
+*/
+class StereoScreen : public Screen {
+public:
+	void Logic(u32, u32, touchPosition) override { };
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		Gui::setDepth(1);
+		Gui::Draw_Rect(10, 0, 5, 5, C2D_Color32(255, 255, 255, 255));
+		Gui::setDepth(0);
+		Gui::DrawString(0, 0, 0.5f, C2D_Color32(255, 255, 255, 255), "3D");
+	};
+};
+
+int main() {
+	Gui::init();
+	Gui::setStereo(true, 4, C2D_Color32(0x33, 0x22, 0x11, 0xFF));
+	Host::setSlider(1);
+	Gui::setScreen(std::make_unique<StereoScreen>());
+
+	/* The second frame records the Text straight from the Text Cache. */
+	for (int frame = 0; frame < 2; frame++) {
+		Host::clearCommands();
+		Gui::DrawScreen();
+		Gui::clearTextBufs();
+	}
+
+	const std::vector<Host::Command> &commands = Host::getCommands();
+	CHECK(commands[0].type == Host::CommandType::TargetClear && commands[0].source == TopRight);
+	CHECK(commands[0].color == C2D_Color32(0x33, 0x22, 0x11, 0xFF));
+
+	float left = 0, right = 0;
+	size_t texts = 0;
+	for (size_t i = 0; i < commands.size(); i++) {
+		if (commands[i].type == Host::CommandType::Text && commands[i].text == "3D") texts++;
+		if (commands[i].type != Host::CommandType::Rect) continue;
+		if (commands[i - 1].source == TopRight) right = commands[i].x;
+		else left = commands[i].x;
+	}
+
+	size_t hits = 0, misses = 0;
+	Gui::getTextCacheStats(&hits, &misses);
+
+	CHECK(left == 14 && right == 6);
+	CHECK(texts == 2);
+	CHECK(hits == 1 && misses == 1);
+	CHECK(Gui::getDrawCount() == 4); // Once for every eye.
+
+	Gui::exit();
+	return 0;
+}
@@ -0,0 +1,123 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "asyncLoader.hpp"
+#include "host.hpp"
+#include "screenCommon.hpp"
+
+#include <string>
+
+/*
+	Threaded 'Logic' and deferred screen factories only use what their contracts allow. Run with TSan.
+*/
+class LogicScreen : public Screen {
+public:
+	bool Threaded() const override { return true; };
+	void Logic(u32, u32, touchPosition) override {
+		for (int i = 0; i < 50; i++) this->width += Gui::GetStringWidth(0.5f, "Logic " + std::to_string(this->count++));
+	};
+	void Publish() override {
+		this->shown = this->width;
+		this->Invalidate();
+		Gui::requestRedraw();
+	};
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		for (int i = 0; i < 50; i++) Gui::GetStringWidth(0.5f, "Draw " + std::to_string(i));
+		Gui::DrawString(0, 0, 0.5f, C2D_Color32(255, 255, 255, 255), std::to_string(this->shown));
+	};
+private:
+	float width = 0, shown = 0;
+	int count = 0;
+};
+
+static bool loadingDrawn = false;
+
+class LoadingScreen : public Screen {
+public:
+	LoadingScreen() {
+		Gui::loadSheet("threads.t3x", this->loaded);
+		this->acquired = Gui::acquireSheet("threads.t3x");
+		this->async = Gui::acquireSheetAsync("threads.t3x");
+		Gui::GetStringWidth(1.0f, "Lädt ✓");
+		this->async->Wait();
+	};
+	~LoadingScreen() {
+		Gui::unloadSheet(this->loaded);
+		Gui::unloadSheet(this->acquired);
+		Gui::releaseAsset(this->async);
+	};
+
+	void Logic(u32, u32, touchPosition) override { };
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		Gui::DrawSprite(this->async, 0, 0, 0);
+		loadingDrawn = true;
+	};
+private:
+	C2D_SpriteSheet loaded = nullptr, acquired = nullptr;
+	std::shared_ptr<AsyncAsset> async;
+};
+
+static void runFrames(int frames) {
+	for (int frame = 0; frame < frames; frame++) {
+		Gui::ScreenLogic(0, 0, { 0, 0 }, true);
+		C3D_FrameBegin(C3D_FRAME_SYNCDRAW);
+		Gui::DrawScreen();
+		Gui::fadeEffects();
+		C3D_FrameEnd(0);
+		Gui::clearTextBufs();
+	}
+}
+
+int main() {
+	FILE *file = fopen("threads.t3x", "wb");
+	fputs("sheet", file);
+	fclose(file);
+
+	Gui::init();
+	CHECK(Gui::setThreadedLogic(true));
+
+	Gui::setScreen(std::make_unique<LogicScreen>());
+	runFrames(50);
+
+	Gui::prefetchSheet("threads.t3x");
+	Gui::setScreenDeferred([]() { return std::make_unique<LoadingScreen>(); });
+
+	/* The factory runs on its own thread, so give it the time it needs. */
+	for (int frame = 0; frame < 1000 && !loadingDrawn; frame++) {
+		runFrames(1);
+		svcSleepThread(1000000);
+	}
+
+	runFrames(60);
+	CHECK(loadingDrawn);
+	CHECK(Gui::getAssetInfo().size() > 0);
+
+	Gui::exit();
+	return 0;
+}
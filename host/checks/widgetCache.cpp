@@ -0,0 +1,74 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "check.hpp"
+#include "host.hpp"
+#include "screenCommon.hpp"
+
+/*
+	Cached widgets dropped by the budget stay valid for the sprite batch and the display lists, which still draw them.
+	ASan catches it otherwise.
+*/
+class WidgetScreen : public Screen {
+public:
+	bool Retained() const override { return true; };
+	void Logic(u32, u32, touchPosition) override { };
+	void Draw() const override {
+		Gui::ScreenDraw(Top);
+		Gui::drawCached("first", 0, 0, 400, 240, []() { Gui::Draw_Rect(0, 0, 10, 10, C2D_Color32(255, 0, 0, 255)); });
+		Gui::drawCached("second", 0, 0, 400, 240, []() { Gui::Draw_Rect(0, 0, 10, 10, C2D_Color32(0, 255, 0, 255)); });
+	};
+};
+
+int main() {
+	Gui::init();
+	Gui::setScreen(std::make_unique<WidgetScreen>());
+	Gui::beginSpriteBatch();
+
+	for (int frame = 0; frame < 6; frame++) {
+		C3D_FrameBegin(C3D_FRAME_SYNCDRAW);
+		Host::clearCommands();
+		Gui::DrawScreen();
+
+		/* Drops both widgets of the screen from the cache. */
+		Gui::ScreenDraw(Bottom);
+		Gui::drawCached("third", 0, 0, 400, 240, []() { Gui::Draw_Rect(0, 0, 10, 10, C2D_Color32(0, 0, 255, 255)); });
+		Gui::flushSpriteBatch();
+
+		C3D_FrameEnd(0);
+		Gui::clearTextBufs();
+	}
+
+	size_t images = 0;
+	for (const Host::Command &command : Host::getCommands()) images += command.type == Host::CommandType::Image;
+
+	CHECK(images == 3);
+	CHECK(Gui::getDrawCount() == 3);
+
+	Gui::endSpriteBatch();
+	Gui::exit();
+	return 0;
+}
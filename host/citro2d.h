@@ -0,0 +1,117 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+
+/*
+	Host stand-in for <citro2d.h>, see 'host.hpp'.
+
+	Nothing gets rendered, the draw calls get recorded as 'Host::Command's instead.
+*/
+
+#ifndef _UNIVERSAL_CORE_HOST_CITRO2D_H
+#define _UNIVERSAL_CORE_HOST_CITRO2D_H
+
+#include <citro3d.h>
+
+#define C2D_DEFAULT_MAX_OBJECTS 4096
+
+typedef struct C2D_TextBuf_s *C2D_TextBuf;
+typedef struct C2D_Font_s *C2D_Font;
+typedef struct C2D_SpriteSheet_s *C2D_SpriteSheet;
+
+typedef struct {
+	C2D_TextBuf buf;
+	size_t begin;
+	size_t end;
+	float width;
+	u32 lines;
+	u32 words;
+	C2D_Font font;
+} C2D_Text;
+
+typedef struct {
+	C3D_Tex *tex;
+	const Tex3DS_SubTexture *subtex;
+} C2D_Image;
+
+typedef struct {
+	u32 color;
+	float blend;
+} C2D_Tint;
+
+typedef struct {
+	C2D_Tint corners[4];
+} C2D_ImageTint;
+
+enum {
+	C2D_AtBaseline = BIT(0),
+	C2D_WithColor = BIT(1),
+	C2D_AlignLeft = 0 << 2,
+	C2D_AlignRight = 1 << 2,
+	C2D_AlignCenter = 2 << 2,
+	C2D_AlignJustified = 3 << 2,
+	C2D_AlignMask = 3 << 2,
+	C2D_WordWrap = BIT(4)
+};
+
+static inline u32 C2D_Color32(u8 r, u8 g, u8 b, u8 a) { return r | (g << (u32)8) | (b << (u32)16) | (a << (u32)24); }
+
+bool C2D_Init(size_t maxObjects);
+void C2D_Fini(void);
+void C2D_Prepare(void);
+void C2D_Flush(void);
+C3D_RenderTarget *C2D_CreateScreenTarget(gfxScreen_t screen, gfx3dSide_t side);
+void C2D_SceneBegin(C3D_RenderTarget *target);
+void C2D_TargetClear(C3D_RenderTarget *target, u32 color);
+
+C2D_TextBuf C2D_TextBufNew(size_t maxGlyphs);
+C2D_TextBuf C2D_TextBufResize(C2D_TextBuf buf, size_t maxGlyphs);
+void C2D_TextBufDelete(C2D_TextBuf buf);
+void C2D_TextBufClear(C2D_TextBuf buf);
+size_t C2D_TextBufGetNumGlyphs(C2D_TextBuf buf);
+const char *C2D_TextParse(C2D_Text *text, C2D_TextBuf buf, const char *str);
+const char *C2D_TextFontParse(C2D_Text *text, C2D_Font font, C2D_TextBuf buf, const char *str);
+void C2D_TextOptimize(const C2D_Text *text);
+void C2D_TextGetDimensions(const C2D_Text *text, float scaleX, float scaleY, float *outWidth, float *outHeight);
+void C2D_DrawText(const C2D_Text *text, u32 flags, float x, float y, float z, float scaleX, float scaleY, ...);
+
+C2D_Font C2D_FontLoad(const char *filename);
+C2D_Font C2D_FontLoadFromMem(const void *data, size_t size);
+C2D_Font C2D_FontLoadSystem(CFG_Region region);
+void C2D_FontFree(C2D_Font font);
+int C2D_FontGlyphIndexFromCodePoint(C2D_Font font, u32 codepoint);
+void C2D_FontCalcGlyphPos(C2D_Font font, fontGlyphPos_s *out, int glyphIndex, u32 flags, float scaleX, float scaleY);
+
+C2D_SpriteSheet C2D_SpriteSheetLoad(const char *filename);
+C2D_SpriteSheet C2D_SpriteSheetLoadFromMem(const void *data, size_t size);
+void C2D_SpriteSheetFree(C2D_SpriteSheet sheet);
+size_t C2D_SpriteSheetCount(C2D_SpriteSheet sheet);
+C2D_Image C2D_SpriteSheetGetImage(C2D_SpriteSheet sheet, size_t index);
+
+bool C2D_DrawImageAt(C2D_Image img, float x, float y, float depth, const C2D_ImageTint *tint = nullptr, float scaleX = 1.0f, float scaleY = 1.0f);
+bool C2D_DrawRectSolid(float x, float y, float z, float w, float h, u32 clr);
+
+#endif
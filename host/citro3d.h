@@ -0,0 +1,97 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+
+/*
+	Host stand-in for <citro3d.h>, see 'host.hpp'.
+*/
+
+#ifndef _UNIVERSAL_CORE_HOST_CITRO3D_H
+#define _UNIVERSAL_CORE_HOST_CITRO3D_H
+
+#include <3ds.h>
+#include <math.h>
+
+#define C3D_DEFAULT_CMDBUF_SIZE 0x40000
+#define C3D_FRAME_SYNCDRAW BIT(0)
+#define C3D_FRAME_NONBLOCK BIT(1)
+
+typedef enum { GPU_RGBA8 = 0x0, GPU_RGB8 = 0x1, GPU_RGBA5551 = 0x2, GPU_RGB565 = 0x3, GPU_RGBA4 = 0x4 } GPU_TEXCOLOR;
+typedef enum { GPU_TEXFACE_2D = 0 } GPU_TEXFACE;
+typedef enum { GPU_RB_DEPTH16 = 0, GPU_RB_DEPTH24 = 2, GPU_RB_DEPTH24_STENCIL8 = 3 } GPU_DEPTHBUF;
+typedef enum { GPU_SCISSOR_DISABLE = 0, GPU_SCISSOR_INVERT = 1, GPU_SCISSOR_NORMAL = 3 } GPU_SCISSORMODE;
+
+/* Like citro3d in C++: a GPU_DEPTHBUF, or -1 for no depth buffer. */
+union C3D_DEPTHTYPE {
+	int __i;
+	GPU_DEPTHBUF __e;
+
+	C3D_DEPTHTYPE(GPU_DEPTHBUF e) : __e(e) { }
+	C3D_DEPTHTYPE(int i) : __i(-1) { (void)i; }
+};
+
+#define C3D_DEPTHTYPE_OK(_x) ((_x).__i >= 0)
+#define C3D_DEPTHTYPE_VAL(_x) ((_x).__e)
+
+typedef struct {
+	void *data;
+	GPU_TEXCOLOR fmt;
+	size_t size;
+	u16 width;
+	u16 height;
+} C3D_Tex;
+
+typedef struct {
+	u16 width;
+	u16 height;
+	float left;
+	float top;
+	float right;
+	float bottom;
+} Tex3DS_SubTexture;
+
+typedef struct {
+	u16 width;
+	u16 height;
+	bool hasDepth;
+	C3D_Tex *tex; // nullptr for a screen.
+} C3D_RenderTarget;
+
+bool C3D_Init(size_t cmdBufSize);
+void C3D_Fini(void);
+bool C3D_FrameBegin(u8 flags);
+bool C3D_FrameDrawOn(C3D_RenderTarget *target);
+void C3D_FrameEnd(u8 flags);
+void C3D_SetScissor(GPU_SCISSORMODE mode, u32 left, u32 top, u32 right, u32 bottom);
+
+bool C3D_TexInit(C3D_Tex *tex, u16 width, u16 height, GPU_TEXCOLOR format);
+bool C3D_TexInitVRAM(C3D_Tex *tex, u16 width, u16 height, GPU_TEXCOLOR format);
+void C3D_TexDelete(C3D_Tex *tex);
+
+C3D_RenderTarget *C3D_RenderTargetCreateFromTex(C3D_Tex *tex, GPU_TEXFACE face, int level, C3D_DEPTHTYPE depthFmt);
+void C3D_RenderTargetDelete(C3D_RenderTarget *target);
+
+#endif
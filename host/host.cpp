@@ -0,0 +1,529 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+
+#include "host.hpp"
+
+#include <citro2d.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+
+static std::vector<Host::Command> commands;
+static u32 frameCount = 0;
+static u32 nextHeld = 0, held = 0, down = 0, up = 0;
+static touchPosition nextTouch = { 0, 0 }, touch = { 0, 0 };
+static float sliderState = 0;
+static bool stereo = false, mainLoopRunning = true;
+
+const std::vector<Host::Command> &Host::getCommands(void) { return commands; };
+void Host::clearCommands(void) { commands.clear(); };
+u32 Host::getFrameCount(void) { return frameCount; };
+void Host::setSlider(float state) { sliderState = state; };
+void Host::exitMainLoop(void) { mainLoopRunning = false; };
+
+void Host::setInput(u32 held, touchPosition touch) {
+	nextHeld = held;
+	nextTouch = touch;
+}
+
+/*
+	Input.
+*/
+void hidScanInput(void) {
+	down = nextHeld & ~held;
+	up = held & ~nextHeld;
+	held = nextHeld;
+	touch = (held & KEY_TOUCH) ? nextTouch : touchPosition { 0, 0 };
+}
+
+u32 hidKeysDown(void) { return down; };
+u32 hidKeysDownRepeat(void) { return down; };
+u32 hidKeysHeld(void) { return held; };
+u32 hidKeysUp(void) { return up; };
+void hidTouchRead(touchPosition *pos) { *pos = touch; };
+
+/*
+	System.
+*/
+u64 svcGetSystemTick(void) {
+	const u64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	return (ns / 1000000000) * SYSCLOCK_ARM11 + (ns % 1000000000) * SYSCLOCK_ARM11 / 1000000000;
+}
+
+Result svcGetThreadPriority(s32 *out, Handle) {
+	*out = 0x30;
+	return 0;
+}
+
+void svcSleepThread(s64 ns) { std::this_thread::sleep_for(std::chrono::nanoseconds(ns)); };
+u64 osGetTime(void) { return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count(); };
+float osGet3DSliderState(void) { return sliderState; };
+bool aptMainLoop(void) { return mainLoopRunning; };
+Result romfsInit(void) { return 0; };
+Result romfsExit(void) { return 0; };
+
+ssize_t decode_utf8(uint32_t *out, const uint8_t *in) {
+	if (in[0] < 0x80) {
+		*out = in[0];
+		return in[0] ? 1 : 0;
+	}
+
+	const size_t length = (in[0] & 0xE0) == 0xC0 ? 2 : (in[0] & 0xF0) == 0xE0 ? 3 : (in[0] & 0xF8) == 0xF0 ? 4 : 0;
+	if (length == 0) return -1;
+
+	u32 codepoint = in[0] & (0x7F >> length);
+	for (size_t i = 1; i < length; i++) {
+		if ((in[i] & 0xC0) != 0x80) return -1;
+		codepoint = (codepoint << 6) | (in[i] & 0x3F);
+	}
+
+	*out = codepoint;
+	return length;
+}
+
+static void encodeUtf8(std::string &out, u32 codepoint) {
+	if (codepoint < 0x80) {
+		out += (char)codepoint;
+	} else if (codepoint < 0x800) {
+		out += (char)(0xC0 | (codepoint >> 6));
+		out += (char)(0x80 | (codepoint & 0x3F));
+	} else if (codepoint < 0x10000) {
+		out += (char)(0xE0 | (codepoint >> 12));
+		out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		out += (char)(0x80 | (codepoint & 0x3F));
+	} else {
+		out += (char)(0xF0 | (codepoint >> 18));
+		out += (char)(0x80 | ((codepoint >> 12) & 0x3F));
+		out += (char)(0x80 | ((codepoint >> 6) & 0x3F));
+		out += (char)(0x80 | (codepoint & 0x3F));
+	}
+}
+
+/*
+	Graphics.
+*/
+void gfxInitDefault(void) { };
+void gfxExit(void) { };
+void gfxSet3D(bool enable) { stereo = enable; };
+bool gfxIs3D(void) { return stereo; };
+void gspWaitForVBlank(void) { };
+
+/*
+	Threads.
+*/
+struct Thread_tag {
+	std::thread thread;
+};
+
+static thread_local Thread currentThread = nullptr;
+static std::mutex syncMutex; // One mutex and condition for all LightLocks and LightEvents is plenty for tests.
+static std::condition_variable syncCondition;
+
+Thread threadCreate(ThreadFunc entrypoint, void *arg, size_t, int, int, bool detached) {
+	Thread thread = new Thread_tag;
+	std::thread started([thread, entrypoint, arg, detached]() {
+		currentThread = thread;
+		entrypoint(arg);
+		if (detached) delete thread; // Detached threads free themselves.
+	});
+
+	if (detached) started.detach();
+	else thread->thread = std::move(started);
+
+	return thread;
+}
+
+Result threadJoin(Thread thread, u64) {
+	if (thread->thread.joinable()) thread->thread.join();
+	return 0;
+}
+
+void threadFree(Thread thread) { delete thread; };
+Thread threadGetCurrent(void) { return currentThread; };
+
+void LightLock_Init(LightLock *lock) { *lock = 0; };
+
+void LightLock_Lock(LightLock *lock) {
+	std::unique_lock<std::mutex> guard(syncMutex);
+	syncCondition.wait(guard, [lock]() { return *lock == 0; });
+	*lock = 1;
+}
+
+int LightLock_TryLock(LightLock *lock) {
+	std::lock_guard<std::mutex> guard(syncMutex);
+	if (*lock != 0) return 1;
+
+	*lock = 1;
+	return 0;
+}
+
+void LightLock_Unlock(LightLock *lock) {
+	{
+		std::lock_guard<std::mutex> guard(syncMutex);
+		*lock = 0;
+	}
+
+	syncCondition.notify_all();
+}
+
+/* 'thread_tag' is the owning thread, with 0 for none. Other threads only compare it, so relaxed atomics are enough. */
+static u32 threadTag(void) {
+	static std::atomic<u32> nextTag { 1 };
+	static thread_local u32 tag = nextTag++;
+	return tag;
+}
+
+void RecursiveLock_Init(RecursiveLock *lock) {
+	LightLock_Init(&lock->lock);
+	lock->thread_tag = 0;
+	lock->counter = 0;
+}
+
+void RecursiveLock_Lock(RecursiveLock *lock) {
+	if (__atomic_load_n(&lock->thread_tag, __ATOMIC_RELAXED) != threadTag()) {
+		LightLock_Lock(&lock->lock);
+		__atomic_store_n(&lock->thread_tag, threadTag(), __ATOMIC_RELAXED);
+	}
+
+	lock->counter++;
+}
+
+int RecursiveLock_TryLock(RecursiveLock *lock) {
+	if (__atomic_load_n(&lock->thread_tag, __ATOMIC_RELAXED) != threadTag()) {
+		if (LightLock_TryLock(&lock->lock) != 0) return 1;
+		__atomic_store_n(&lock->thread_tag, threadTag(), __ATOMIC_RELAXED);
+	}
+
+	lock->counter++;
+	return 0;
+}
+
+void RecursiveLock_Unlock(RecursiveLock *lock) {
+	if (--lock->counter == 0) {
+		__atomic_store_n(&lock->thread_tag, 0, __ATOMIC_RELAXED);
+		LightLock_Unlock(&lock->lock);
+	}
+}
+
+/* 'state' is 1 while signaled, 'lock' keeps the ResetType. */
+void LightEvent_Init(LightEvent *event, ResetType reset_type) {
+	event->state = 0;
+	event->lock = reset_type;
+}
+
+void LightEvent_Clear(LightEvent *event) {
+	std::lock_guard<std::mutex> guard(syncMutex);
+	event->state = 0;
+}
+
+void LightEvent_Signal(LightEvent *event) {
+	{
+		std::lock_guard<std::mutex> guard(syncMutex);
+		event->state = event->lock == RESET_PULSE ? 0 : 1; // Waiting threads of a pulse event are not tracked.
+	}
+
+	syncCondition.notify_all();
+}
+
+int LightEvent_TryWait(LightEvent *event) {
+	std::lock_guard<std::mutex> guard(syncMutex);
+	if (event->state == 0) return 0;
+
+	if (event->lock == RESET_ONESHOT) event->state = 0;
+	return 1;
+}
+
+void LightEvent_Wait(LightEvent *event) {
+	std::unique_lock<std::mutex> guard(syncMutex);
+	syncCondition.wait(guard, [event]() { return event->state != 0; });
+	if (event->lock == RESET_ONESHOT) event->state = 0;
+}
+
+int LightEvent_WaitTimeout(LightEvent *event, s64 timeout_ns) {
+	std::unique_lock<std::mutex> guard(syncMutex);
+	if (!syncCondition.wait_for(guard, std::chrono::nanoseconds(timeout_ns), [event]() { return event->state != 0; })) return 1; // Timed out.
+
+	if (event->lock == RESET_ONESHOT) event->state = 0;
+	return 0;
+}
+
+/*
+	citro3d.
+*/
+static C3D_RenderTarget screens[3] = { }; // Top left, top right and bottom.
+
+bool C3D_Init(size_t) { return true; };
+void C3D_Fini(void) { };
+bool C3D_FrameBegin(u8) { return true; };
+bool C3D_FrameDrawOn(C3D_RenderTarget *) { return true; };
+void C3D_FrameEnd(u8) { frameCount++; };
+
+bool C3D_TexInit(C3D_Tex *tex, u16 width, u16 height, GPU_TEXCOLOR format) {
+	*tex = { nullptr, format, (size_t)width * height * 4, width, height };
+	return true;
+}
+
+bool C3D_TexInitVRAM(C3D_Tex *tex, u16 width, u16 height, GPU_TEXCOLOR format) { return C3D_TexInit(tex, width, height, format); };
+void C3D_TexDelete(C3D_Tex *tex) { tex->size = 0; };
+
+C3D_RenderTarget *C3D_RenderTargetCreateFromTex(C3D_Tex *tex, GPU_TEXFACE, int, C3D_DEPTHTYPE depthFmt) {
+	return new C3D_RenderTarget { tex->width, tex->height, C3D_DEPTHTYPE_OK(depthFmt), tex };
+}
+
+void C3D_RenderTargetDelete(C3D_RenderTarget *target) {
+	if (target < screens || target >= screens + 3) delete target;
+}
+
+/*
+	citro2d.
+*/
+struct HostGlyph {
+	u32 codepoint;
+	u32 line;
+};
+
+struct C2D_TextBuf_s {
+	size_t capacity;
+	std::vector<HostGlyph> glyphs;
+};
+
+struct C2D_Font_s {
+	bool system;
+};
+
+struct C2D_SpriteSheet_s {
+	C3D_Tex tex;
+	std::vector<Tex3DS_SubTexture> images;
+};
+
+static C2D_Font_s systemFont = { true };
+
+/* Universal-Core only creates and frees Fonts and SpriteSheets on the main thread, the host holds it to that. */
+static void mainThreadOnly(const char *function) {
+	if (!currentThread) return;
+
+	fprintf(stderr, "%s called off the main thread\n", function);
+	abort();
+}
+
+static void addCommand(Host::CommandType type, float x, float y, float w, float h, u32 color, const void *source, u32 flags = 0, float wrapWidth = 0, const std::string &text = "") {
+	commands.push_back({ type, x, y, w, h, color, source, flags, wrapWidth, text });
+}
+
+bool C2D_Init(size_t) { return true; };
+void C2D_Fini(void) { };
+void C2D_Prepare(void) { };
+void C2D_Flush(void) { };
+
+/* citro3d, but recorded like the draw calls. */
+void C3D_SetScissor(GPU_SCISSORMODE mode, u32 left, u32 top, u32 right, u32 bottom) {
+	addCommand(Host::CommandType::Scissor, left, top, right, bottom, 0, nullptr, mode);
+}
+
+C3D_RenderTarget *C2D_CreateScreenTarget(gfxScreen_t screen, gfx3dSide_t side) {
+	C3D_RenderTarget *target = &screens[screen == GFX_BOTTOM ? 2 : side];
+	target->width = screen == GFX_BOTTOM ? 320 : 400;
+	target->height = 240;
+	return target;
+}
+
+void C2D_SceneBegin(C3D_RenderTarget *target) { addCommand(Host::CommandType::SceneBegin, 0, 0, 0, 0, 0, target); };
+void C2D_TargetClear(C3D_RenderTarget *target, u32 color) { addCommand(Host::CommandType::TargetClear, 0, 0, 0, 0, color, target); };
+
+C2D_TextBuf C2D_TextBufNew(size_t maxGlyphs) { return new C2D_TextBuf_s { maxGlyphs, { } }; };
+
+/* Like the real one, the Textbuffer may move, so C2D_Texts parsed before point to freed memory. */
+C2D_TextBuf C2D_TextBufResize(C2D_TextBuf buf, size_t maxGlyphs) {
+	C2D_TextBuf resized = new C2D_TextBuf_s { maxGlyphs, std::move(buf->glyphs) };
+	if (resized->glyphs.size() > maxGlyphs) resized->glyphs.resize(maxGlyphs);
+
+	delete buf;
+	return resized;
+}
+
+void C2D_TextBufDelete(C2D_TextBuf buf) { delete buf; };
+void C2D_TextBufClear(C2D_TextBuf buf) { buf->glyphs.clear(); };
+size_t C2D_TextBufGetNumGlyphs(C2D_TextBuf buf) { return buf->glyphs.size(); };
+const char *C2D_TextParse(C2D_Text *text, C2D_TextBuf buf, const char *str) { return C2D_TextFontParse(text, nullptr, buf, str); };
+
+const char *C2D_TextFontParse(C2D_Text *text, C2D_Font font, C2D_TextBuf buf, const char *str) {
+	*text = { buf, buf->glyphs.size(), buf->glyphs.size(), 0, 1, 0, font };
+	const u8 *p = (const u8 *)str;
+	u32 lineGlyphs = 0;
+	bool inWord = false;
+
+	while (*p) {
+		u32 codepoint;
+		const ssize_t units = decode_utf8(&codepoint, p);
+		if (units <= 0) break;
+
+		if (codepoint == '\n') {
+			text->lines++;
+			lineGlyphs = 0;
+			inWord = false;
+		} else {
+			if (buf->glyphs.size() >= buf->capacity) break;
+
+			buf->glyphs.push_back({ codepoint, text->lines - 1 });
+			text->width = std::max(text->width, ++lineGlyphs * Host::GLYPH_WIDTH);
+
+			if (codepoint == ' ') {
+				inWord = false;
+			} else if (!inWord) {
+				text->words++;
+				inWord = true;
+			}
+		}
+
+		p += units;
+	}
+
+	text->end = buf->glyphs.size();
+	return (const char *)p;
+}
+
+void C2D_TextOptimize(const C2D_Text *) { };
+
+void C2D_TextGetDimensions(const C2D_Text *text, float scaleX, float scaleY, float *outWidth, float *outHeight) {
+	if (outWidth) *outWidth = text->width * scaleX;
+	if (outHeight) *outHeight = ceilf(Host::LINE_HEIGHT * scaleY) * text->lines;
+}
+
+void C2D_DrawText(const C2D_Text *text, u32 flags, float x, float y, float, float scaleX, float scaleY, ...) {
+	u32 color = 0xFF000000;
+	float wrapWidth = 0;
+
+	va_list args;
+	va_start(args, scaleY);
+	if (flags & C2D_WithColor) color = va_arg(args, u32);
+	if (flags & C2D_WordWrap) wrapWidth = va_arg(args, double);
+	va_end(args);
+
+	std::string str;
+	for (size_t i = text->begin; i < text->end; i++) {
+		if (i > text->begin && text->buf->glyphs[i].line != text->buf->glyphs[i - 1].line) str += '\n';
+		encodeUtf8(str, text->buf->glyphs[i].codepoint);
+	}
+
+	addCommand(Host::CommandType::Text, x, y, scaleX, scaleY, color, text->font, flags, wrapWidth, str);
+}
+
+static C2D_Font hostFontLoad(bool found) {
+	mainThreadOnly("C2D_FontLoad");
+	return found ? new C2D_Font_s { false } : nullptr;
+}
+
+C2D_Font C2D_FontLoad(const char *filename) {
+	FILE *file = fopen(filename, "rb");
+	if (file) fclose(file);
+
+	return hostFontLoad(file != nullptr);
+}
+
+C2D_Font C2D_FontLoadFromMem(const void *data, size_t size) { return hostFontLoad(data && size > 0); };
+C2D_Font C2D_FontLoadSystem(CFG_Region) { return &systemFont; };
+
+void C2D_FontFree(C2D_Font font) {
+	mainThreadOnly("C2D_FontFree");
+	if (font != &systemFont) delete font;
+}
+
+int C2D_FontGlyphIndexFromCodePoint(C2D_Font, u32 codepoint) { return codepoint; };
+
+void C2D_FontCalcGlyphPos(C2D_Font, fontGlyphPos_s *out, int, u32, float scaleX, float) {
+	*out = { };
+	out->xAdvance = out->width = Host::GLYPH_WIDTH * scaleX;
+}
+
+/*
+	Read the image sizes of an uncompressed .t3x, everything else gets fallback images.
+
+	A .t3x starts with a compression header, then the Tex3DS header (u16 image count, one byte each for the
+	texture size, type, format and mipmaps) and the images (u16 width, height, left, top, right and bottom).
+*/
+C2D_SpriteSheet C2D_SpriteSheetLoadFromMem(const void *data, size_t size) {
+	mainThreadOnly("C2D_SpriteSheetLoad");
+	if (!data || size == 0) return nullptr;
+
+	const u8 *bytes = (const u8 *)data;
+	auto read16 = [bytes](size_t offset) { return (u16)(bytes[offset] | (bytes[offset + 1] << 8)); };
+
+	C2D_SpriteSheet sheet = new C2D_SpriteSheet_s { { }, { } };
+	size_t header = (size >= 4 && (bytes[1] | bytes[2] | bytes[3]) == 0) ? 8 : 4;
+
+	if (bytes[0] == 0x00 && size >= header + 6 && size >= header + 6 + read16(header) * 12) {
+		const u8 sizes = bytes[header + 2];
+		C3D_TexInit(&sheet->tex, 8 << (sizes & 7), 8 << ((sizes >> 3) & 7), GPU_RGBA8);
+
+		for (size_t i = 0, count = read16(header); i < count; i++) {
+			const size_t offset = header + 6 + i * 12;
+			sheet->images.push_back({ read16(offset), read16(offset + 2), read16(offset + 4) / 1024.0f,
+				read16(offset + 6) / 1024.0f, read16(offset + 8) / 1024.0f, read16(offset + 10) / 1024.0f });
+		}
+
+	} else {
+		C3D_TexInit(&sheet->tex, 512, 512, GPU_RGBA8);
+		sheet->images.assign(Host::FALLBACK_IMAGES, { 32, 32, 0, 1, 1, 0 });
+	}
+
+	return sheet;
+}
+
+C2D_SpriteSheet C2D_SpriteSheetLoad(const char *filename) {
+	FILE *file = fopen(filename, "rb");
+	if (!file) return nullptr;
+
+	std::vector<u8> data;
+	u8 chunk[4096];
+	size_t read;
+	while ((read = fread(chunk, 1, sizeof(chunk), file)) > 0) data.insert(data.end(), chunk, chunk + read);
+	fclose(file);
+
+	return C2D_SpriteSheetLoadFromMem(data.data(), data.size());
+}
+
+void C2D_SpriteSheetFree(C2D_SpriteSheet sheet) {
+	mainThreadOnly("C2D_SpriteSheetFree");
+	delete sheet;
+}
+size_t C2D_SpriteSheetCount(C2D_SpriteSheet sheet) { return sheet->images.size(); };
+C2D_Image C2D_SpriteSheetGetImage(C2D_SpriteSheet sheet, size_t index) { return { &sheet->tex, &sheet->images[index] }; };
+
+bool C2D_DrawImageAt(C2D_Image img, float x, float y, float, const C2D_ImageTint *, float scaleX, float scaleY) {
+	addCommand(Host::CommandType::Image, x, y, img.subtex->width * scaleX, img.subtex->height * scaleY, 0, img.tex);
+	return true;
+}
+
+bool C2D_DrawRectSolid(float x, float y, float, float w, float h, u32 clr) {
+	addCommand(Host::CommandType::Rect, x, y, w, h, clr, nullptr);
+	return true;
+}
@@ -0,0 +1,115 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+
+#ifndef _UNIVERSAL_CORE_HOST_HPP
+#define _UNIVERSAL_CORE_HOST_HPP
+
+#include <3ds.h>
+#include <string>
+#include <vector>
+
+/*
+	Host layer.
+
+	Stand-ins for <3ds.h>, <citro2d.h> and <citro3d.h>, so Universal-Core and the screens of an app
+	can be built and run on a PC without a display, e.g. for tests, 'InputRecord::replay' or 'Benchmark::run'.
+	Put this directory in front of the include path and build 'host.cpp' with the rest:
+
+		g++ -std=gnu++17 -I<core>/host -I<core> <app sources> <core sources> <core>/host/host.cpp -lpthread
+
+	Or run 'make' in this directory for a static library, and 'make check' for the checks in 'checks/'.
+
+	Nothing gets rendered, every citro2d draw call gets recorded as a 'Host::Command' instead.
+	Fonts are monospaced, every glyph is 'GLYPH_WIDTH' wide and every line 'LINE_HEIGHT' high at a scale of 1.
+	SpriteSheets and Fonts load from host paths, "romfs:/" doesn't exist on the host.
+	An uncompressed .t3x keeps its image sizes, any other SpriteSheet gets 'FALLBACK_IMAGES' images of 32x32.
+	Threads and locks are real threads and locks, ticks come from the host clock.
+*/
+namespace Host {
+	constexpr float GLYPH_WIDTH = 12.0f, LINE_HEIGHT = 30.0f;
+	constexpr size_t FALLBACK_IMAGES = 256;
+
+	enum class CommandType : u8 {
+		SceneBegin, // source: The render target.
+		TargetClear, // color, source: The render target.
+		Rect, // x, y, w, h, color.
+		Image, // x, y, w, h: The drawn size, source: The C3D_Tex.
+		Text, // x, y, w: X-Scale, h: Y-Scale, color, source: The Font, flags, wrapWidth, text.
+		Scissor // x, y, w, h: The left, top, right and bottom in framebuffer coordinates, flags: The GPU_SCISSORMODE.
+	};
+
+	/*
+		A recorded citro2d draw call.
+	*/
+	struct Command {
+		CommandType type;
+		float x, y, w, h;
+		u32 color;
+		const void *source;
+		u32 flags;
+		float wrapWidth;
+		std::string text;
+	};
+
+	/*
+		Get the draw calls since the last 'clearCommands'.
+	*/
+	const std::vector<Command> &getCommands(void);
+
+	/*
+		Forget the recorded draw calls.
+	*/
+	void clearCommands(void);
+
+	/*
+		Get the amount of 'C3D_FrameEnd' calls.
+	*/
+	u32 getFrameCount(void);
+
+	/*
+		Set the input, which the next 'hidScanInput' picks up.
+		'hidKeysDown' and 'hidKeysUp' are derived from the held keys of the previous scan, 'hidKeysDownRepeat' equals 'hidKeysDown'.
+
+		held: The held keys.
+		touch: The touch position, only used while KEY_TOUCH is held.
+	*/
+	void setInput(u32 held, touchPosition touch);
+
+	/*
+		Set the state of the 3D slider.
+
+		state: The state from 0.0 to 1.0.
+	*/
+	void setSlider(float state);
+
+	/*
+		Let 'aptMainLoop' return false from now on, so the main loop of the app ends.
+	*/
+	void exitMainLoop(void);
+};
+
+#endif
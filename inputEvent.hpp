@@ -0,0 +1,46 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_INPUT_EVENT_HPP
+#define _UNIVERSAL_CORE_INPUT_EVENT_HPP
+
+#include <3ds.h>
+
+/*
+	An input event, created by 'Gui::ScreenLogic' out of the key and touch state changes.
+*/
+struct InputEvent {
+	enum class Type : u8 { KeyDown, KeyRepeat, KeyUp, TouchDown, TouchMove, TouchUp };
+
+	Type type;
+	u32 keys; // The keys of the Key events, or KEY_TOUCH.
+	touchPosition touch; // The touch position, for Touch events the latest one.
+	touchPosition from; // For TouchMove, the position before the first merged sample.
+	u16 samples; // For TouchMove, how many samples got merged into this event.
+	u64 timestamp; // The system tick of the first sample, compare with 'svcGetSystemTick' for the latency.
+};
+
+#endif
@@ -0,0 +1,197 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifdef UC_INPUT_RECORD
+
+#include "animation.hpp"
+#include "gui.hpp"
+#include "inputRecord.hpp"
+#include "screenCommon.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+/*
+	File format: "UCIR", u32 version, then records of a u16 count and a Frame, all little endian.
+	The count says how many frames in a row had exactly this content.
+*/
+struct Frame {
+	u32 hDown, hDownRepeat, hHeld;
+	u16 px, py;
+	u8 fade; // Bit 0: fadeout, 1: fadein, 2: fadeout2, 3: fadein2.
+} __attribute__((packed));
+
+static constexpr u32 VERSION = 1;
+
+static FILE *recordFile = nullptr;
+static Frame lastFrame;
+static u16 lastCount = 0;
+
+static u8 fadeState(void) { return fadeout | (fadein << 1) | (fadeout2 << 2) | (fadein2 << 3); };
+
+static void writeRun(void) {
+	if (lastCount == 0) return;
+
+	fwrite(&lastCount, sizeof(lastCount), 1, recordFile);
+	fwrite(&lastFrame, sizeof(lastFrame), 1, recordFile);
+	lastCount = 0;
+}
+
+/*
+	Start recording into a file.
+
+	const std::string &path: The path of the file.
+*/
+bool InputRecord::startRecording(const std::string &path) {
+	InputRecord::stopRecording();
+
+	recordFile = fopen(path.c_str(), "wb");
+	if (!recordFile) return false;
+
+	fwrite("UCIR", 4, 1, recordFile);
+	fwrite(&VERSION, sizeof(VERSION), 1, recordFile);
+	return true;
+}
+
+/*
+	Finish the recording.
+*/
+void InputRecord::stopRecording(void) {
+	if (!recordFile) return;
+
+	writeRun();
+	fclose(recordFile);
+	recordFile = nullptr;
+}
+
+bool InputRecord::recording(void) { return recordFile != nullptr; };
+
+/*
+	Add a frame to the recording.
+
+	u32 hDown: The hidKeysDown() variable.
+	u32 hDownRepeat: The hidKeysDownRepeat() variable.
+	u32 hHeld: The hidKeysHeld() variable.
+	touchPosition touch: The touchPosition variable.
+*/
+void InputRecord::addFrame(u32 hDown, u32 hDownRepeat, u32 hHeld, touchPosition touch) {
+	if (!recordFile) return;
+
+	const Frame frame = { hDown, hDownRepeat, hHeld, touch.px, touch.py, fadeState() };
+
+	if (lastCount > 0 && lastCount < 0xFFFF && !memcmp(&frame, &lastFrame, sizeof(Frame))) {
+		lastCount++;
+		return;
+	}
+
+	writeRun();
+	lastFrame = frame;
+	lastCount = 1;
+}
+
+/*
+	Replay a recording against the current screen.
+
+	const std::string &path: The path of the file.
+	InputRecord::Report &report: Where to store the result.
+	bool waitFade: The waitFade value for 'Gui::ScreenLogic'.
+	bool stack: Is it the stack variant?
+	u32 clearColor: The color the screens get cleared with.
+*/
+bool InputRecord::replay(const std::string &path, InputRecord::Report &report, bool waitFade, bool stack, u32 clearColor) {
+	FILE *file = fopen(path.c_str(), "rb");
+	if (!file) return false;
+
+	char magic[4];
+	u32 version = 0;
+	if (fread(magic, 4, 1, file) != 1 || memcmp(magic, "UCIR", 4) || fread(&version, sizeof(version), 1, file) != 1 || version != VERSION) {
+		fclose(file);
+		return false;
+	}
+
+	std::vector<u64> times;
+	u64 draws = 0;
+	report = { };
+
+	const bool wasRecording = InputRecord::recording();
+	if (wasRecording) writeRun(); // Don't record the replay as new frames.
+	FILE *paused = recordFile;
+	recordFile = nullptr;
+
+	Animation::setTimeStep(1.0f / 60.0f);
+
+	u16 count;
+	Frame frame;
+	while (fread(&count, sizeof(count), 1, file) == 1 && fread(&frame, sizeof(frame), 1, file) == 1) {
+		const touchPosition touch = { frame.px, frame.py };
+
+		for (u16 i = 0; i < count; i++) {
+			if (fadeState() != frame.fade) report.fadeMismatches++;
+
+			C3D_FrameBegin(C3D_FRAME_SYNCDRAW);
+			C2D_TargetClear(Top, clearColor);
+			C2D_TargetClear(Bottom, clearColor);
+
+			/* Only the CPU side gets measured, waiting for the GPU and VBlank would hide the differences. */
+			const u64 start = svcGetSystemTick();
+#ifdef UC_KEY_REPEAT
+			Gui::ScreenLogic(frame.hDown, frame.hDownRepeat, frame.hHeld, touch, waitFade, stack);
+#else
+			Gui::ScreenLogic(frame.hDown, frame.hHeld, touch, waitFade, stack);
+#endif
+			Gui::fadeEffects(6, 6, stack);
+			Gui::DrawScreen(stack);
+			times.push_back(svcGetSystemTick() - start);
+
+			C3D_FrameEnd(0);
+			Gui::clearTextBufs();
+
+			const size_t frameDraws = Gui::getDrawCount();
+			draws += frameDraws;
+			report.drawsMax = std::max<u32>(report.drawsMax, frameDraws);
+		}
+	}
+
+	fclose(file);
+	Animation::setTimeStep(0);
+	recordFile = paused;
+
+	if (times.empty()) return true;
+
+	std::sort(times.begin(), times.end());
+	auto ms = [](u64 ticks) { return (float)ticks * 1000.0f / SYSCLOCK_ARM11; };
+
+	report.frames = times.size();
+	report.p50 = ms(times[(times.size() - 1) / 2]);
+	report.p99 = ms(times[(times.size() - 1) * 99 / 100]);
+	report.max = ms(times.back());
+	report.drawsAverage = (float)draws / times.size();
+	return true;
+}
+
+#endif
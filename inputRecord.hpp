@@ -0,0 +1,96 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_INPUT_RECORD_HPP
+#define _UNIVERSAL_CORE_INPUT_RECORD_HPP
+
+#ifdef UC_INPUT_RECORD
+
+#include <3ds.h>
+#include <string>
+
+/*
+	Recording and replaying of the input passed to 'Gui::ScreenLogic'. (Optional!)
+
+	Only compiled in with UC_INPUT_RECORD defined.
+	Every frame stores the keys, the touch position and the fade state. Repeated frames, like idle ones, get run-length encoded.
+	A replay feeds the frames to the same screens again with a fixed animation time step, so it runs the same way every time,
+	and measures the CPU time of the logic and drawing of every frame.
+	Replays also run on a PC without a display, built with the host layer in 'host/'. The times are host times then,
+	but the draw counts and fade mismatches stay the same as on the console.
+*/
+namespace InputRecord {
+	/*
+		The result of a replay. Times are in milliseconds.
+	*/
+	struct Report {
+		u32 frames;
+		float p50, p99, max;
+		float drawsAverage;
+		u32 drawsMax;
+		u32 fadeMismatches; // Frames where the fade state differs from the recording, so the replay went another way.
+	};
+
+	/*
+		Start recording into a file. 'Gui::ScreenLogic' adds a frame on every call.
+
+		path: The path of the file.
+	*/
+	bool startRecording(const std::string &path);
+
+	/*
+		Finish the recording and write the remaining frames.
+	*/
+	void stopRecording(void);
+
+	bool recording(void);
+
+	/*
+		Add a frame to the recording. Called by 'Gui::ScreenLogic'.
+
+		hDown: The hidKeysDown() variable.
+		hDownRepeat: The hidKeysDownRepeat() variable, 0 without UC_KEY_REPEAT.
+		hHeld: The hidKeysHeld() variable.
+		touch: The touchPosition variable.
+	*/
+	void addFrame(u32 hDown, u32 hDownRepeat, u32 hHeld, touchPosition touch);
+
+	/*
+		Replay a recording against the current screen.
+
+		path: The path of the file.
+		report: Where to store the result.
+		waitFade: The waitFade value for 'Gui::ScreenLogic'. (Optional!)
+		stack: Is it the stack variant? (Optional!)
+		clearColor: The color the screens get cleared with before drawing. (Optional!)
+		Every frame runs 'Gui::ScreenLogic', 'Gui::fadeEffects' with its default speeds and 'Gui::DrawScreen' inside of a C3D frame.
+	*/
+	bool replay(const std::string &path, Report &report, bool waitFade = true, bool stack = false, u32 clearColor = 0xFF000000);
+};
+
+#endif
+
+#endif
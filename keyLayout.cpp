@@ -0,0 +1,107 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "keyLayout.hpp"
+
+#include <algorithm>
+#include <unordered_map>
+
+/*
+	Compile the keys into the layout.
+
+	const std::vector<Structs::Key> &keys: The keys.
+	int keyHeight: The height of the keys.
+	float textSize: The size of the labels.
+	C2D_Font fnt: The font of the labels.
+*/
+void KeyLayout::Compile(const std::vector<Structs::Key> &keys, int keyHeight, float textSize, C2D_Font fnt) {
+	std::unordered_map<std::string, u16> interned;
+	std::vector<float> widths;
+
+	this->keys.clear();
+	this->hits.Clear();
+	this->labels.clear();
+	this->order.resize(keys.size());
+	this->keyHeight = keyHeight;
+	this->textSize = textSize;
+	this->fnt = fnt;
+	this->labelOffset = (keyHeight - Gui::GetStringHeight(textSize, " ", fnt)) / 2;
+
+	for (size_t i = 0; i < keys.size(); i++) {
+		auto found = interned.find(keys[i].character);
+
+		if (found == interned.end()) {
+			found = interned.emplace(keys[i].character, this->labels.size()).first;
+			this->labels.push_back(keys[i].character);
+			widths.push_back(Gui::GetStringWidth(textSize, keys[i].character, fnt));
+		}
+
+		this->keys.push_back({ (s16)keys[i].x, (s16)keys[i].y, (s16)keys[i].w, found->second, (u16)i, widths[found->second] });
+	}
+
+	std::stable_sort(this->keys.begin(), this->keys.end(), [](const CompiledKey &a, const CompiledKey &b) {
+		return a.y != b.y ? a.y < b.y : a.x < b.x;
+	});
+
+	/* In drawing order, so keys drawn later lay on top for 'Hit' too. */
+	for (size_t i = 0; i < this->keys.size(); i++) {
+		const CompiledKey &key = this->keys[i];
+		this->order[key.source] = i;
+		this->hits.Insert(key.source, { key.x, key.y, key.w, keyHeight });
+	}
+}
+
+/*
+	Return the index of the touched key, or -1.
+
+	const touchPosition &touch: The touchPosition variable.
+*/
+int KeyLayout::Hit(const touchPosition &touch) const { return this->hits.Hit(touch); };
+
+/*
+	Draw the keyboard.
+
+	u32 keyColor: The color of the keys.
+	u32 textColor: The color of the labels.
+	u32 pressedColor: The color of the pressed key.
+	int pressed: The index of the pressed key, or -1 for none.
+	float offsetX: Moves the whole keyboard on the X-Axis.
+	float offsetY: Moves the whole keyboard on the Y-Axis.
+*/
+void KeyLayout::Draw(u32 keyColor, u32 textColor, u32 pressedColor, int pressed, float offsetX, float offsetY) const {
+	this->rects.resize(this->keys.size());
+
+	for (size_t i = 0; i < this->keys.size(); i++) {
+		const CompiledKey &key = this->keys[i];
+		this->rects[i] = { key.x + offsetX, key.y + offsetY, (float)key.w, (float)this->keyHeight, key.source == pressed ? pressedColor : keyColor };
+	}
+
+	Gui::Draw_Rects(this->rects.data(), this->rects.size());
+
+	for (const CompiledKey &key : this->keys) {
+		Gui::DrawString(key.x + offsetX + (key.w - key.labelWidth) / 2, key.y + offsetY + this->labelOffset, this->textSize, textColor, this->labels[key.label], 0, 0, this->fnt);
+	}
+}
@@ -0,0 +1,115 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_KEY_LAYOUT_HPP
+#define _UNIVERSAL_CORE_KEY_LAYOUT_HPP
+
+#include "gui.hpp"
+#include "hitIndex.hpp"
+#include "structs.hpp"
+
+#include <citro2d.h>
+#include <string>
+#include <vector>
+
+/*
+	A keyboard layout compiled out of Structs::Key.
+
+	The keys get stored in a flat table sorted by rows, every label only once and with its width measured at compile time.
+	'Hit' goes through a HitIndex, so the keys may have any position and even overlap. Overlapping keys resolve to the one drawn last.
+	'Draw' draws all key backgrounds in one pass. All keys share one height, Structs::Key has none of its own.
+	The key indices stay the ones of the Structs::Key vector.
+*/
+class KeyLayout {
+public:
+	struct CompiledKey {
+		s16 x, y, w;
+		u16 label; // Index into the interned labels.
+		u16 source; // Index in the Structs::Key vector.
+		float labelWidth;
+	};
+
+	KeyLayout() { };
+
+	/*
+		keys: The keys.
+		keyHeight: The height of the keys.
+		textSize: The size of the labels. (Optional!)
+		fnt: The font of the labels. (Optional!)
+	*/
+	KeyLayout(const std::vector<Structs::Key> &keys, int keyHeight, float textSize = 0.5f, C2D_Font fnt = nullptr) {
+		this->Compile(keys, keyHeight, textSize, fnt);
+	};
+
+	/*
+		Compile the keys into the layout, replacing the old ones.
+
+		keys: The keys.
+		keyHeight: The height of the keys.
+		textSize: The size of the labels. (Optional!)
+		fnt: The font of the labels. (Optional!)
+	*/
+	void Compile(const std::vector<Structs::Key> &keys, int keyHeight, float textSize = 0.5f, C2D_Font fnt = nullptr);
+
+	size_t Count() const { return this->keys.size(); };
+
+	/*
+		Return the label of a key.
+
+		index: The index of the key in the Structs::Key vector.
+	*/
+	const std::string &Label(size_t index) const { return this->labels[this->keys[this->order[index]].label]; };
+
+	/*
+		Return the index of the touched key in the Structs::Key vector, or -1 if none got touched.
+
+		touch: The touchPosition variable.
+	*/
+	int Hit(const touchPosition &touch) const;
+
+	/*
+		Draw the keyboard.
+
+		keyColor: The color of the keys.
+		textColor: The color of the labels.
+		pressedColor: The color of the pressed key. (Optional!)
+		pressed: The index of the pressed key, or -1 for none. (Optional!)
+		offsetX: Moves the whole keyboard on the X-Axis. (Optional!)
+		offsetY: Moves the whole keyboard on the Y-Axis. (Optional!)
+	*/
+	void Draw(u32 keyColor, u32 textColor, u32 pressedColor = 0, int pressed = -1, float offsetX = 0, float offsetY = 0) const;
+private:
+	std::vector<CompiledKey> keys; // Sorted by Y, then X, the drawing order.
+	HitIndex hits; // IDs are the Structs::Key indices.
+	std::vector<u16> order; // Position in 'keys' of every Structs::Key index.
+	std::vector<std::string> labels;
+	mutable std::vector<Gui::Rect> rects;
+	int keyHeight = 0;
+	float textSize = 0.5f, labelOffset = 0;
+	C2D_Font fnt = nullptr;
+};
+
+#endif
@@ -0,0 +1,250 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "listView.hpp"
+
+#include <algorithm>
+
+ListView::ListView(const Structs::ButtonPos &area, int rowHeight, size_t poolSize) : area(area), rowHeight(std::max(rowHeight, 1)) {
+	this->pool.resize(std::max<size_t>(poolSize, 1));
+}
+
+/*
+	Set the entries of the list.
+
+	size_t count: The amount of entries.
+	const std::function<std::string(size_t)> &text: Returns the text of an entry.
+*/
+void ListView::SetSource(size_t count, const std::function<std::string(size_t)> &text) {
+	this->count = count;
+	this->text = text;
+	this->Invalidate();
+
+	if (this->selected >= (int)count) this->selected = -1;
+	this->SetScroll(this->scroll);
+}
+
+/*
+	Set the look of the list.
+
+	float textSize: The size of the text.
+	u32 textColor: The color of the text.
+	u32 rowColor: The color of even rows.
+	u32 altRowColor: The color of odd rows.
+	u32 selectedColor: The color of the selected row.
+	C2D_Font fnt: The font to use.
+*/
+void ListView::SetStyle(float textSize, u32 textColor, u32 rowColor, u32 altRowColor, u32 selectedColor, C2D_Font fnt) {
+	this->textSize = textSize;
+	this->textColor = textColor;
+	this->rowColor = rowColor;
+	this->altRowColor = altRowColor;
+	this->selectedColor = selectedColor;
+	this->fnt = fnt;
+	this->Invalidate(); // The fitted texts depend on the size and font.
+}
+
+/*
+	Let an entry, or all entries, get fetched and measured again.
+
+	int index: The index of the entry, or -1 for all.
+*/
+void ListView::Invalidate(int index) {
+	if (index < 0) {
+		for (Row &row : this->pool) row.used = false;
+		return;
+	}
+
+	Row &row = this->pool[index % this->pool.size()];
+	if (row.index == (size_t)index) row.used = false;
+}
+
+int ListView::MaxScroll() const {
+	return std::max(0, (int)this->count * this->rowHeight - this->area.h);
+}
+
+/*
+	Scroll to a pixel offset, clamped to the list.
+
+	int offset: The offset from the top of the first row.
+*/
+void ListView::SetScroll(int offset) {
+	this->scroll = std::max(0, std::min(offset, this->MaxScroll()));
+}
+
+/*
+	Scroll as little as possible, so an entry is fully visible.
+
+	size_t index: The index of the entry.
+*/
+void ListView::ScrollTo(size_t index) {
+	const int top = index * this->rowHeight;
+
+	if (top < this->scroll) this->SetScroll(top);
+	else if (top + this->rowHeight > this->scroll + this->area.h) this->SetScroll(top + this->rowHeight - this->area.h);
+}
+
+/*
+	Select an entry and scroll to it.
+
+	int index: The index of the entry, or -1 for none.
+*/
+void ListView::Select(int index) {
+	this->selected = (index >= 0 && index < (int)this->count) ? index : -1;
+	if (this->selected >= 0) this->ScrollTo(this->selected);
+}
+
+/*
+	Return the index of the touched entry, or -1.
+
+	const touchPosition &touch: The touchPosition variable.
+*/
+int ListView::Hit(const touchPosition &touch) const {
+	if (!this->area.Touched(touch) || touch.py >= this->area.y + this->area.h) return -1;
+
+	const size_t index = (touch.py - this->area.y + this->scroll) / this->rowHeight;
+	return index < this->count ? (int)index : -1;
+}
+
+/*
+	Handle an input event.
+
+	const InputEvent &event: The event.
+*/
+int ListView::HandleEvent(const InputEvent &event) {
+	switch(event.type) {
+		case InputEvent::Type::TouchDown:
+			this->dragging = this->area.Touched(event.touch);
+			this->dragged = false;
+			this->dragDistance = 0;
+			break;
+
+		case InputEvent::Type::TouchMove:
+			if (this->dragging) {
+				const int amount = event.from.py - event.touch.py;
+				this->dragDistance += std::abs(amount);
+				if (this->dragDistance > 4) this->dragged = true; // Small jitter still counts as a tap.
+
+				this->ScrollBy(amount);
+			}
+			break;
+
+		case InputEvent::Type::TouchUp:
+			if (this->dragging && !this->dragged) {
+				this->dragging = false;
+				const int index = this->Hit(event.touch);
+				if (index >= 0) this->selected = index;
+				return index;
+			}
+
+			this->dragging = false;
+			break;
+
+		case InputEvent::Type::KeyDown:
+		case InputEvent::Type::KeyRepeat:
+			if (this->count == 0) break;
+
+			if (event.keys & KEY_DOWN) this->Select(std::min(this->selected + 1, (int)this->count - 1));
+			else if (event.keys & KEY_UP) this->Select(std::max(this->selected - 1, 0));
+			else if (event.type == InputEvent::Type::KeyDown && (event.keys & KEY_A)) return this->selected;
+			break;
+
+		default:
+			break;
+	}
+
+	return -1;
+}
+
+/*
+	Return the cached row of an entry, fetching and fitting its text on a miss.
+
+	size_t index: The index of the entry.
+*/
+const ListView::Row &ListView::GetRow(size_t index) const {
+	Row &row = this->pool[index % this->pool.size()];
+	if (row.used && row.index == index) return row;
+
+	row.index = index;
+	row.used = true;
+	row.text = this->text ? this->text(index) : "";
+
+	/* Shorten too long texts by whole UTF-8 characters and end them with "...". */
+	const float maxWidth = this->area.w - 8;
+	if (Gui::GetStringWidth(this->textSize, row.text, this->fnt) > maxWidth) {
+		std::vector<size_t> ends; // The end of every UTF-8 character.
+		for (size_t i = 1; i <= row.text.size(); i++) {
+			if (i == row.text.size() || (row.text[i] & 0xC0) != 0x80) ends.push_back(i);
+		}
+
+		/* Binary search the most characters which still fit, the whole text doesn't. */
+		size_t fitting = 0, tooMany = ends.size();
+		while (tooMany - fitting > 1) {
+			const size_t middle = (fitting + tooMany) / 2;
+			if (Gui::GetStringWidth(this->textSize, row.text.substr(0, ends[middle - 1]) + "...", this->fnt) > maxWidth) tooMany = middle;
+			else fitting = middle;
+		}
+
+		row.text.resize(fitting > 0 ? ends[fitting - 1] : 0);
+		row.text += "...";
+	}
+
+	return row;
+}
+
+/*
+	Draw the visible rows.
+*/
+void ListView::Draw() const {
+	if (this->count == 0) return;
+
+	const size_t first = this->scroll / this->rowHeight;
+	const size_t last = std::min(this->count, (size_t)(this->scroll + this->area.h + this->rowHeight - 1) / this->rowHeight);
+	const float textOffset = (this->rowHeight - Gui::GetStringHeight(this->textSize, " ", this->fnt)) / 2;
+
+	this->rects.resize(last - first);
+	for (size_t i = first; i < last; i++) {
+		/* Cut the rows at the edges of the list. */
+		const float y = this->area.y + (int)i * this->rowHeight - this->scroll;
+		const float top = std::max<float>(y, this->area.y), bottom = std::min<float>(y + this->rowHeight, this->area.y + this->area.h);
+		const u32 color = (int)i == this->selected ? this->selectedColor : (i % 2 ? this->altRowColor : this->rowColor);
+
+		this->rects[i - first] = { (float)this->area.x, top, (float)this->area.w, bottom - top, color };
+	}
+
+	Gui::Draw_Rects(this->rects.data(), this->rects.size());
+
+	/* Only clip, if a row sticks out. Every clip ends the current draw batch. */
+	const bool cut = this->scroll % this->rowHeight != 0 || (int)last * this->rowHeight - this->scroll > this->area.h;
+	if (cut) Gui::SetClip(this->area.x, this->area.y, this->area.w, this->area.h);
+
+	for (size_t i = first; i < last; i++) {
+		const float y = this->area.y + (int)i * this->rowHeight - this->scroll;
+		Gui::DrawString(this->area.x + 4, y + textOffset, this->textSize, this->textColor, this->GetRow(i).text, 0, 0, this->fnt);
+	}
+
+	if (cut) Gui::ResetClip();
+}
@@ -0,0 +1,153 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_LIST_VIEW_HPP
+#define _UNIVERSAL_CORE_LIST_VIEW_HPP
+
+#include "gui.hpp"
+#include "inputEvent.hpp"
+#include "structs.hpp"
+
+#include <citro2d.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+/*
+	A scrolling list of text rows, which only measures and draws the visible rows.
+
+	The row texts come from a function, so the entries don't need to be copied into the list.
+	The fitted row texts are kept in a small pool indexed by the row, so scrolling only measures the rows coming into view.
+	Touching is resolved from the scroll offset, without checking every row.
+	Rows cut by the edges of the list get clipped with 'Gui::SetClip'.
+*/
+class ListView {
+public:
+	/*
+		area: The position and size of the list.
+		rowHeight: The height of a row.
+		poolSize: The amount of cached rows. Should be more than the visible rows. (Optional!)
+	*/
+	ListView(const Structs::ButtonPos &area, int rowHeight, size_t poolSize = 32);
+
+	/*
+		Set the entries of the list.
+
+		count: The amount of entries.
+		text: Returns the text of an entry.
+	*/
+	void SetSource(size_t count, const std::function<std::string(size_t)> &text);
+
+	/*
+		Set the look of the list.
+
+		textSize: The size of the text.
+		textColor: The color of the text.
+		rowColor: The color of even rows.
+		altRowColor: The color of odd rows.
+		selectedColor: The color of the selected row.
+		fnt: The font to use. (Optional!)
+	*/
+	void SetStyle(float textSize, u32 textColor, u32 rowColor, u32 altRowColor, u32 selectedColor, C2D_Font fnt = nullptr);
+
+	/*
+		Let an entry, or with -1 all entries, get fetched and measured again, after its text changed.
+
+		index: The index of the entry. (Optional!)
+	*/
+	void Invalidate(int index = -1);
+
+	/*
+		Scroll to a pixel offset, clamped to the list.
+
+		offset: The offset from the top of the first row.
+	*/
+	void SetScroll(int offset);
+	void ScrollBy(int amount) { this->SetScroll(this->scroll + amount); };
+	int Scroll() const { return this->scroll; };
+
+	/*
+		Scroll as little as possible, so an entry is fully visible.
+
+		index: The index of the entry.
+	*/
+	void ScrollTo(size_t index);
+
+	/*
+		Select an entry and scroll to it.
+
+		index: The index of the entry, or -1 for none.
+	*/
+	void Select(int index);
+	int Selected() const { return this->selected; };
+
+	/*
+		Return the index of the touched entry, or -1 if none got touched.
+
+		touch: The touchPosition variable.
+	*/
+	int Hit(const touchPosition &touch) const;
+
+	/*
+		Handle an input event. Dragging scrolls, Up and Down move the selection.
+
+		event: The event, for example from 'Screen::OnEvent'.
+		Returns the index of the tapped entry or the selected one on A, otherwise -1.
+	*/
+	int HandleEvent(const InputEvent &event);
+
+	/*
+		Draw the visible rows.
+	*/
+	void Draw() const;
+private:
+	struct Row {
+		size_t index;
+		std::string text; // Shortened to fit the row.
+		bool used;
+	};
+
+	const Row &GetRow(size_t index) const;
+	int MaxScroll() const;
+
+	Structs::ButtonPos area;
+	int rowHeight;
+	mutable std::vector<Row> pool; // Indexed by entry index modulo the pool size.
+	mutable std::vector<Gui::Rect> rects; // Reused for the row backgrounds.
+	std::function<std::string(size_t)> text;
+	size_t count = 0;
+	int scroll = 0, selected = -1;
+
+	float textSize = 0.5f;
+	u32 textColor = C2D_Color32(255, 255, 255, 255), rowColor = C2D_Color32(40, 40, 40, 255);
+	u32 altRowColor = C2D_Color32(50, 50, 50, 255), selectedColor = C2D_Color32(70, 110, 170, 255);
+	C2D_Font fnt = nullptr;
+
+	bool dragging = false, dragged = false;
+	int dragDistance = 0;
+};
+
+#endif
@@ -0,0 +1,128 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifdef UC_PROFILER
+
+#include "gui.hpp"
+#include "profiler.hpp"
+
+#include <cstdio>
+
+static Profiler::FrameStats frames[Profiler::FRAMES] = { };
+static size_t currentFrame = 0, finishedFrames = 0;
+static bool paused = false;
+
+static const char *sectionNames[Profiler::SectionCount] = {
+	"DrawString", "GetStringSize", "DrawSprite", "Draw_Rect", "ScreenLogic", "DrawScreen", "fadeEffects"
+};
+
+static float ticksToMs(u64 ticks) { return (float)ticks * 1000.0f / SYSCLOCK_ARM11; };
+
+Profiler::Scope::Scope(Profiler::Section section) : section(section), start(svcGetSystemTick()) { }
+
+Profiler::Scope::~Scope() {
+	if (paused || threadGetCurrent()) return; // Only the main thread gets profiled.
+
+	frames[currentFrame].calls[this->section]++;
+	frames[currentFrame].ticks[this->section] += svcGetSystemTick() - this->start;
+}
+
+/*
+	Count parsed glyphs.
+
+	u32 glyphs: The amount of glyphs.
+*/
+void Profiler::addGlyphs(u32 glyphs) {
+	if (!paused && !threadGetCurrent()) frames[currentFrame].glyphs += glyphs;
+}
+
+/*
+	Finish the current frame.
+*/
+void Profiler::endFrame(void) {
+	currentFrame = (currentFrame + 1) % Profiler::FRAMES;
+	frames[currentFrame] = { };
+	if (finishedFrames < Profiler::FRAMES - 1) finishedFrames++;
+}
+
+/*
+	Return the stats of a finished frame.
+
+	size_t ago: 0 for the last finished frame.
+*/
+const Profiler::FrameStats &Profiler::frame(size_t ago) {
+	return frames[(currentFrame + Profiler::FRAMES - 1 - (ago % (Profiler::FRAMES - 1))) % Profiler::FRAMES];
+}
+
+/*
+	Draw the stats of the last frame.
+
+	float x: The X Position of the overlay.
+	float y: The Y Position of the overlay.
+*/
+void Profiler::drawOverlay(float x, float y) {
+	const Profiler::FrameStats &stats = Profiler::frame();
+	char line[64];
+
+	paused = true;
+	Gui::Draw_Rect(x, y, 170, 12 * (Profiler::SectionCount + 1) + 4, C2D_Color32(0, 0, 0, 190));
+
+	for (size_t i = 0; i < Profiler::SectionCount; i++) {
+		snprintf(line, sizeof(line), "%s: %lu, %.2f ms", sectionNames[i], (unsigned long)stats.calls[i], ticksToMs(stats.ticks[i]));
+		Gui::DrawString(x + 2, y + 2 + 12 * i, 0.35f, C2D_Color32(255, 255, 255, 255), line);
+	}
+
+	snprintf(line, sizeof(line), "Glyphs parsed: %lu", (unsigned long)stats.glyphs);
+	Gui::DrawString(x + 2, y + 2 + 12 * Profiler::SectionCount, 0.35f, C2D_Color32(255, 255, 255, 255), line);
+	paused = false;
+}
+
+/*
+	Write the ring buffer as CSV to a file.
+
+	const char *path: The path of the file.
+*/
+bool Profiler::dump(const char *path) {
+	FILE *file = fopen(path, "w");
+	if (!file) return false;
+
+	fputs("frame", file);
+	for (size_t i = 0; i < Profiler::SectionCount; i++) fprintf(file, ",%s calls,%s ms", sectionNames[i], sectionNames[i]);
+	fputs(",glyphs\n", file);
+
+	for (size_t ago = finishedFrames; ago-- > 0;) {
+		const Profiler::FrameStats &stats = Profiler::frame(ago);
+
+		fprintf(file, "%zu", finishedFrames - 1 - ago);
+		for (size_t i = 0; i < Profiler::SectionCount; i++) fprintf(file, ",%lu,%.3f", (unsigned long)stats.calls[i], ticksToMs(stats.ticks[i]));
+		fprintf(file, ",%lu\n", (unsigned long)stats.glyphs);
+	}
+
+	fclose(file);
+	return true;
+}
+
+#endif
@@ -0,0 +1,111 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_PROFILER_HPP
+#define _UNIVERSAL_CORE_PROFILER_HPP
+
+#include <3ds.h>
+
+/*
+	Per frame profiling of the Gui. (Optional!)
+
+	Only compiled in with UC_PROFILER defined, otherwise 'UC_PROFILE' expands to nothing
+	and the functions are empty, so calls to them don't need to be guarded.
+	'Gui::clearTextBufs' counts as the end of a frame. Times of nested sections are included in the outer ones,
+	like the DrawString calls inside of DrawScreen. Only the main thread gets profiled.
+*/
+namespace Profiler {
+	enum Section : u8 { DrawString, GetStringSize, DrawSprite, DrawRect, ScreenLogic, DrawScreen, FadeEffects, SectionCount };
+
+	static constexpr size_t FRAMES = 120; // The amount of frames kept in the ring buffer.
+
+	struct FrameStats {
+		u32 calls[SectionCount];
+		u64 ticks[SectionCount];
+		u32 glyphs; // Glyphs parsed in this frame.
+	};
+
+#ifdef UC_PROFILER
+	/*
+		Measures the time between its construction and destruction.
+	*/
+	class Scope {
+	public:
+		Scope(Section section);
+		~Scope();
+	private:
+		Section section;
+		u64 start;
+	};
+
+	/*
+		Count parsed glyphs.
+
+		glyphs: The amount of glyphs.
+	*/
+	void addGlyphs(u32 glyphs);
+
+	/*
+		Finish the current frame and move to the next ring buffer entry.
+	*/
+	void endFrame(void);
+
+	/*
+		Return the stats of a finished frame.
+
+		ago: 0 for the last finished frame, up to FRAMES - 1.
+	*/
+	const FrameStats &frame(size_t ago = 0);
+
+	/*
+		Draw the stats of the last frame, for example on the bottom screen. Not counted itself.
+
+		x: The X Position of the overlay.
+		y: The Y Position of the overlay.
+	*/
+	void drawOverlay(float x = 0, float y = 0);
+
+	/*
+		Write the ring buffer as CSV to a file, oldest frame first.
+
+		path: The path of the file.
+	*/
+	bool dump(const char *path);
+#else
+	inline void addGlyphs(u32) { };
+	inline void endFrame(void) { };
+	inline void drawOverlay(float = 0, float = 0) { };
+	inline bool dump(const char *) { return false; };
+#endif
+};
+
+#ifdef UC_PROFILER
+	#define UC_PROFILE(section) Profiler::Scope _ucProfileScope(Profiler::section)
+#else
+	#define UC_PROFILE(section)
+#endif
+
+#endif
@@ -27,8 +27,12 @@
 #ifndef _UNIVERSAL_CORE_SCREEN_HPP
 #define _UNIVERSAL_CORE_SCREEN_HPP
 
+#include "displayList.hpp"
+#include "inputEvent.hpp"
+
 #include <3ds.h>
 #include <memory>
+#include <unordered_map>
 
 class Screen {
 public:
@@ -39,6 +43,113 @@ public:
 	virtual void Logic(u32 hDown, u32 hHeld, touchPosition touch) = 0;
 #endif
 	virtual void Draw() const = 0;
+
+	/*
+		Event driven input. (Optional!)
+		Return true, to get 'OnEvent' for every input event instead of 'Logic' every frame.
+		'OnEvent' then only gets called, when something happened.
+	*/
+	virtual bool EventDriven() const { return false; };
+	virtual void OnEvent(const InputEvent &) { };
+
+	/*
+		Threaded logic. (Optional!)
+		Return true, to let 'Logic' or 'OnEvent' run on the logic thread of 'Gui::setThreadedLogic',
+		while 'Draw' of the previous frame runs on the main thread at the same time.
+		For that, keep the state 'Logic' changes apart from the state 'Draw' reads, and copy it over in 'Publish'.
+
+		On the logic thread, 'Logic' may:
+		- change its own logic state,
+		- switch screens with 'Gui::setScreen', 'Gui::setScreenDeferred' and 'Gui::screenBack', which get applied by the next 'Gui::ScreenLogic',
+		- measure Texts with 'Gui::GetStringWidth', 'Gui::GetStringHeight' and 'Gui::GetStringSize'.
+		Everything else of the Gui namespace and the screen belongs to the main thread, so do it in 'Publish' instead.
+		That includes drawing, starting or stopping Animations, 'Invalidate' and 'Gui::requestRedraw'.
+		'Animating' runs on the main thread while 'Logic' runs, so it may only read the draw state.
+	*/
+	virtual bool Threaded() const { return false; };
+
+	/*
+		Called on the main thread after every threaded 'Logic', while the logic thread waits.
+		Copy the logic state into the draw state here, and do what 'Logic' couldn't, like 'Invalidate' or starting Animations.
+	*/
+	virtual void Publish() { };
+
+	/*
+		Return true, while the screen shows an animation, like 'Gui::drawAnimatedSelector'.
+		Used by 'Gui::frameNeedsRender' to not skip those frames.
+	*/
+	virtual bool Animating() const { return false; };
+
+	/*
+		Retained mode. (Optional!)
+		Return true, to let 'Gui::DrawScreen' record the whole Draw once and replay it until 'Invalidate' gets called.
+	*/
+	virtual bool Retained() const { return false; };
+
+	/*
+		Screen cache. (Optional!)
+		Return an id of 0 or higher, to keep the screen in the cache after it got popped from the stack,
+		so 'Gui::reuseScreen' can bring it back instead of constructing it again.
+		The id tells apart multiple instances of the same screen class.
+	*/
+	virtual int CacheId() const { return -1; };
+
+	/*
+		Return the estimated memory the screen keeps while it is suspended, counted against the screen cache budget.
+	*/
+	virtual size_t CacheBytes() const { return 0; };
+
+	/*
+		Called when the screen goes into the screen cache. Free GPU heavy things like sheets here and keep cheap state.
+		Its display lists get invalidated afterwards, so they get recorded again after 'OnResume'.
+	*/
+	virtual void OnSuspend() { };
+
+	/*
+		Called when the screen comes back from the screen cache, before it gets shown again.
+	*/
+	virtual void OnResume() { };
+
+	/*
+		Draw a named part of the screen through a display list.
+		The first call records 'draw', later calls only replay it, until 'Invalidate(name)' gets called.
+		Inside a retained screen, this simply draws, since the whole screen gets recorded anyways.
+
+		name: The name of the part.
+		draw: The drawing code of the part.
+	*/
+	void Retain(const std::string &name, const std::function<void()> &draw) const {
+		if (DisplayList::Recording()) {
+			draw();
+			return;
+		}
+
+		DisplayList &list = this->displayLists[name];
+		if (list.Valid()) list.Replay();
+		else list.Record(draw);
+	};
+
+	/*
+		Let all display lists of the screen get recorded again.
+	*/
+	void Invalidate() {
+		for (auto &list : this->displayLists) list.second.Invalidate();
+	};
+
+	/*
+		Let a named display list get recorded again. This also invalidates the whole screen list.
+
+		name: The name of the part.
+	*/
+	void Invalidate(const std::string &name) {
+		auto list = this->displayLists.find(name);
+		if (list != this->displayLists.end()) list->second.Invalidate();
+
+		list = this->displayLists.find("");
+		if (list != this->displayLists.end()) list->second.Invalidate();
+	};
+private:
+	mutable std::unordered_map<std::string, DisplayList> displayLists;
 };
 
 #endif
\ No newline at end of file
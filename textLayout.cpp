@@ -0,0 +1,201 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#include "gui.hpp"
+#include "textLayout.hpp"
+
+#include <algorithm>
+
+/*
+	Set the Text and wrap it.
+
+	const std::string &Text: The Text.
+*/
+void TextLayout::SetText(const std::string &Text) {
+	this->text = Text;
+	this->lines.clear();
+	this->Wrap(0);
+}
+
+/*
+	Add Text to the end, only wrapping the last line again.
+
+	const std::string &Text: The Text to add.
+*/
+void TextLayout::Append(const std::string &Text) {
+	size_t from = 0;
+
+	if (!this->lines.empty()) {
+		from = this->lines.back().offset;
+		this->lines.pop_back();
+	}
+
+	this->text += Text;
+	this->Wrap(from);
+}
+
+/*
+	Change the size, width or font and wrap the Text again.
+
+	float size: The size of the Text.
+	float width: The width to wrap at.
+	C2D_Font fnt: The font to use.
+*/
+void TextLayout::SetStyle(float size, float width, C2D_Font fnt) {
+	if (size == this->size && width == this->width && fnt == this->fnt && !this->lines.empty()) return;
+
+	this->size = size;
+	this->width = width;
+	this->fnt = fnt;
+	this->lines.clear();
+	this->Wrap(0);
+}
+
+/*
+	Return the width of a part of the Text.
+
+	const char *begin: The start of the part.
+	const char *end: The end of the part.
+*/
+float TextLayout::Width(const char *begin, const char *end) const {
+	return Gui::GetStringWidth(this->size, std::string(begin, end), this->fnt);
+}
+
+/*
+	Wrap the Text starting from a byte offset, which must be the start of a line, and add the lines.
+
+	size_t from: The byte offset.
+*/
+void TextLayout::Wrap(size_t from) {
+	this->lineHeight = Gui::GetStringHeight(this->size, " ", this->fnt);
+
+	const char *start = this->text.c_str(), *p = start + from, *lineStart = p, *lineEnd = p;
+	const float spaceWidth = Gui::GetStringWidth(this->size, " ", this->fnt);
+	float lineWidth = 0;
+
+	auto endLine = [&](const char *next) {
+		this->lines.push_back({ (size_t)(lineStart - start), std::string(lineStart, lineEnd) });
+		lineStart = lineEnd = next;
+		lineWidth = 0;
+	};
+
+	while (*p) {
+		if (*p == '\n') {
+			endLine(p + 1);
+			p++;
+
+		} else if (*p == ' ') {
+			lineWidth += spaceWidth;
+			p++;
+
+		} else {
+			const char *wordEnd = p;
+			while (*wordEnd && *wordEnd != ' ' && *wordEnd != '\n') wordEnd++;
+			float wordWidth = this->Width(p, wordEnd);
+
+			/* Move the word to the next line, the spaces before it stay at the end of this one. */
+			if (lineEnd != lineStart && lineWidth + wordWidth > this->width) {
+				endLine(p);
+			}
+
+			/* Split words which don't fit into a line on their own, by whole UTF-8 characters. */
+			while (wordWidth > this->width - lineWidth && lineEnd == lineStart) {
+				const char *split = p;
+				float splitWidth = 0;
+
+				while (split < wordEnd) {
+					const char *next = split + 1;
+					while (next < wordEnd && (*next & 0xC0) == 0x80) next++;
+
+					const float charWidth = this->Width(split, next);
+					if (split != p && splitWidth + charWidth > this->width) break;
+
+					splitWidth += charWidth;
+					split = next;
+				}
+
+				if (split == wordEnd) break;
+
+				lineEnd = split;
+				endLine(split);
+				wordWidth -= splitWidth;
+				p = split;
+			}
+
+			lineWidth += wordWidth;
+			lineEnd = p = wordEnd;
+		}
+	}
+
+	endLine(p);
+}
+
+/*
+	Return the line at a Y position.
+
+	float y: The Y position relative to the top of the Text.
+*/
+size_t TextLayout::LineAt(float y) const {
+	if (this->lines.empty() || y < 0) return 0;
+
+	return std::min(this->lines.size() - 1, (size_t)(y / this->lineHeight));
+}
+
+/*
+	Draw a range of lines.
+
+	float x: The X position.
+	float y: The Y position.
+	u32 color: The Text color.
+	size_t first: The first line.
+	size_t count: The amount of lines.
+*/
+void TextLayout::Draw(float x, float y, u32 color, size_t first, size_t count) const {
+	const size_t last = first + std::min(count, this->lines.size() - std::min(first, this->lines.size()));
+
+	for (size_t i = first; i < last; i++) {
+		if (!this->lines[i].text.empty()) Gui::DrawString(x, y + (i - first) * this->lineHeight, this->size, color, this->lines[i].text, 0, 0, this->fnt);
+	}
+}
+
+/*
+	Draw the lines which are fully visible in a scrolled view.
+
+	float x: The X position of the view.
+	float y: The Y position of the view.
+	u32 color: The Text color.
+	float scroll: How far the Text is scrolled down.
+	float viewHeight: The height of the view.
+*/
+void TextLayout::DrawVisible(float x, float y, u32 color, float scroll, float viewHeight) const {
+	if (this->lineHeight <= 0) return;
+
+	const size_t first = std::max(0.0f, ceilf(scroll / this->lineHeight));
+	const float top = first * this->lineHeight - scroll;
+	const size_t count = std::max(0.0f, floorf((viewHeight - top) / this->lineHeight));
+
+	this->Draw(x, y + top, color, first, count);
+}
@@ -0,0 +1,136 @@
+/*
+*   This file is part of Universal-Core
+*   Copyright (C) 2020-2021 Universal-Team
+*
+*   This program is free software: you can redistribute it and/or modify
+*   it under the terms of the GNU General Public License as published by
+*   the Free Software Foundation, either version 3 of the License, or
+*   (at your option) any later version.
+*
+*   This program is distributed in the hope that it will be useful,
+*   but WITHOUT ANY WARRANTY; without even the implied warranty of
+*   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+*   GNU General Public License for more details.
+*
+*   You should have received a copy of the GNU General Public License
+*   along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*
+*   Additional Terms 7.b and 7.c of GPLv3 apply to this file:
+*       * Requiring preservation of specified reasonable legal notices or
+*         author attributions in that material or in the Appropriate Legal
+*         Notices displayed by works containing it.
+*       * Prohibiting misrepresentation of the origin of that material,
+*         or requiring that modified versions of such material be marked in
+*         reasonable ways as different from the original version.
+*/
+
+#ifndef _UNIVERSAL_CORE_TEXT_LAYOUT_HPP
+#define _UNIVERSAL_CORE_TEXT_LAYOUT_HPP
+
+#include <3ds.h>
+#include <citro2d.h>
+#include <string>
+#include <vector>
+
+/*
+	A word wrapped Text, which only gets wrapped when the Text, size, width or font changes.
+
+	Words are moved to the next line like with C2D_WordWrap, words longer than the width get split.
+	Appending only wraps the last line again, so logs and changelogs can grow cheaply.
+*/
+class TextLayout {
+public:
+	/*
+		size: The size of the Text.
+		width: The width to wrap at.
+		fnt: The font to use. (Optional!)
+	*/
+	TextLayout(float size, float width, C2D_Font fnt = nullptr) : size(size), width(width), fnt(fnt) { };
+
+	/*
+		Set the Text and wrap it.
+
+		Text: The Text.
+	*/
+	void SetText(const std::string &Text);
+
+	/*
+		Add Text to the end, only wrapping the last line again.
+
+		Text: The Text to add.
+	*/
+	void Append(const std::string &Text);
+
+	/*
+		Change the size, width or font and wrap the Text again.
+
+		size: The size of the Text.
+		width: The width to wrap at.
+		fnt: The font to use. (Optional!)
+	*/
+	void SetStyle(float size, float width, C2D_Font fnt = nullptr);
+
+	const std::string &Text() const { return this->text; };
+	size_t Lines() const { return this->lines.size(); };
+
+	/*
+		Return the byte offset of a line in the Text.
+
+		line: The line.
+	*/
+	size_t LineOffset(size_t line) const { return this->lines[line].offset; };
+
+	/*
+		Return a line, without the spaces it got wrapped at.
+
+		line: The line.
+	*/
+	const std::string &Line(size_t line) const { return this->lines[line].text; };
+
+	float LineHeight() const { return this->lineHeight; };
+	float Height() const { return this->lineHeight * this->lines.size(); };
+
+	/*
+		Return the line at a Y position relative to the top of the Text, clamped to the existing lines.
+
+		y: The Y position.
+	*/
+	size_t LineAt(float y) const;
+
+	/*
+		Draw a range of lines. The first drawn line is at the given position.
+
+		x: The X position.
+		y: The Y position.
+		color: The Text color.
+		first: The first line. (Optional!)
+		count: The amount of lines, all by default. (Optional!)
+	*/
+	void Draw(float x, float y, u32 color, size_t first = 0, size_t count = (size_t)-1) const;
+
+	/*
+		Draw the lines which are fully visible in a scrolled view.
+
+		x: The X position of the view.
+		y: The Y position of the view.
+		color: The Text color.
+		scroll: How far the Text is scrolled down, in pixels.
+		viewHeight: The height of the view.
+	*/
+	void DrawVisible(float x, float y, u32 color, float scroll, float viewHeight) const;
+private:
+	struct WrappedLine {
+		size_t offset;
+		std::string text;
+	};
+
+	void Wrap(size_t from);
+	float Width(const char *begin, const char *end) const;
+
+	std::string text;
+	std::vector<WrappedLine> lines;
+	float size, width, lineHeight = 0;
+	C2D_Font fnt;
+};
+
+#endif